@@ -0,0 +1,454 @@
+// Native benchmark, no python / ctypes in the way.
+// Runs the test_topology.py meshes (benchmark_meshes.h) plus synthetic grids and tori through every level
+// and times each stage of the pipeline separately, then the engine end to end (cold, warm cache, warm stencils),
+// and how well the refined faces use a vertex cache with and without set_reorder (ACMR).
+// Example usage: ./ctypes_OpenSubdiv_benchmark -l 6 -f json -o bench.json
+//   -l <N>       highest level (default 6)
+//   -r <N>       repeats per measurement, the fastest one is reported (default 3)
+//   -m <name>    only meshes whose name contains <name>
+//   -x <N>       skip cases with more than N refined faces (default 4194304)
+//   -f csv|json  output format (default csv)
+//   -o <file>    output file (default stdout)
+#define SUBDIVIDER_NO_MAIN
+#include "ctypes_subdivider.cpp"
+#include "benchmark_meshes.h"
+#include <opensubdiv/version.h>
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+//---------------- Meshes ----------------
+struct bench_mesh {
+    std::string name;
+    std::vector<float> verts;
+    std::vector<int> faceVerts;
+    std::vector<int> vertsPerFace;
+
+    int n_verts() const { return verts.size() / 3; }
+    int n_faces() const { return vertsPerFace.size(); }
+    float (*vertices())[3] { return (float (*)[3])&verts[0]; }
+};
+
+static bench_mesh from_table(benchmark_mesh const& table) {
+    bench_mesh mesh;
+    mesh.name = table.name;
+    mesh.verts.assign(&table.verts[0][0], &table.verts[0][0] + 3 * table.n_verts);
+    mesh.vertsPerFace.assign(table.vertsPerFace, table.vertsPerFace + table.n_faces);
+    int n_faceVerts = 0;
+    for (int i = 0; i < table.n_faces; i++) {
+        n_faceVerts += table.vertsPerFace[i];
+    }
+    mesh.faceVerts.assign(table.faceVerts, table.faceVerts + n_faceVerts);
+    return mesh;
+}
+
+// n x n quads in the z = 0 plane (with a boundary)
+static bench_mesh grid(int n) {
+    bench_mesh mesh;
+    mesh.name = "grid" + std::to_string(n);
+    for (int j = 0; j <= n; j++) {
+        for (int i = 0; i <= n; i++) {
+            mesh.verts.push_back((float)i / n);
+            mesh.verts.push_back((float)j / n);
+            mesh.verts.push_back(0.0f);
+        }
+    }
+    for (int j = 0; j < n; j++) {
+        for (int i = 0; i < n; i++) {
+            int v = j * (n + 1) + i;
+            int quad[4] = { v, v + 1, v + n + 2, v + n + 1 };
+            mesh.faceVerts.insert(mesh.faceVerts.end(), quad, quad + 4);
+            mesh.vertsPerFace.push_back(4);
+        }
+    }
+    return mesh;
+}
+
+// nu x nv quads around a torus (closed, all vertices regular)
+static bench_mesh torus(int nu, int nv) {
+    bench_mesh mesh;
+    mesh.name = "torus" + std::to_string(nu) + "x" + std::to_string(nv);
+    float const two_pi = 6.28318530718f;
+    for (int j = 0; j < nv; j++) {
+        for (int i = 0; i < nu; i++) {
+            float u = two_pi * i / nu, v = two_pi * j / nv;
+            mesh.verts.push_back((1.0f + 0.3f * cosf(v)) * cosf(u));
+            mesh.verts.push_back((1.0f + 0.3f * cosf(v)) * sinf(u));
+            mesh.verts.push_back(0.3f * sinf(v));
+        }
+    }
+    for (int j = 0; j < nv; j++) {
+        for (int i = 0; i < nu; i++) {
+            int i1 = (i + 1) % nu, j1 = (j + 1) % nv;
+            int quad[4] = { j * nu + i, j * nu + i1, j1 * nu + i1, j1 * nu + i };
+            mesh.faceVerts.insert(mesh.faceVerts.end(), quad, quad + 4);
+            mesh.vertsPerFace.push_back(4);
+        }
+    }
+    return mesh;
+}
+
+//---------------- Measuring ----------------
+typedef std::chrono::steady_clock bench_clock;
+
+static double elapsed_ms(bench_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(bench_clock::now() - start).count();
+}
+
+// Peak resident set size in kB. On Linux the peak can be reset (clear_refs), so every case gets its own;
+// elsewhere it's the peak of the whole run so far.
+static void reset_peak_memory() {
+#if defined(__linux__)
+    std::ofstream clear_refs("/proc/self/clear_refs");
+    clear_refs << "5";
+#endif
+}
+
+static long peak_memory_kb() {
+#if defined(__linux__)
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) {
+            return std::atol(line.c_str() + 6);
+        }
+    }
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+#else
+    return 0;
+#endif
+}
+
+// Average cache miss ratio: vertices fetched per triangle (n-gons count as n - 2) through a FIFO vertex cache of
+// cache_size entries, faces in output order. 0.5 is the best a regular quad mesh can do, 3 means no reuse at all.
+static double acmr(int n_verts, int n_faces, int const* vertsPerFace, int const* faceVerts, int cache_size = 32) {
+    std::vector<char> cached(n_verts, 0);
+    std::vector<int> fifo(cache_size, -1);
+    int head = 0;
+    long misses = 0, triangles = 0;
+    for (int f = 0; f < n_faces; f++) {
+        for (int j = 0; j < vertsPerFace[f]; j++) {
+            int v = faceVerts[j];
+            if (!cached[v]) {
+                misses++;
+                if (fifo[head] >= 0) {
+                    cached[fifo[head]] = 0;
+                }
+                fifo[head] = v;
+                cached[v] = 1;
+                head = (head + 1) % cache_size;
+            }
+        }
+        triangles += std::max(vertsPerFace[f] - 2, 1);
+        faceVerts += vertsPerFace[f];
+    }
+    return triangles > 0 ? (double)misses / triangles : 0.0;
+}
+
+struct bench_result {
+    std::string mesh;
+    int level;
+    int verts_in, faces_in;
+    int verts_out, edges_out, faces_out;
+    // Stages
+    double descriptor_ms, refine_ms, interpolate_ms, extract_ms, copyout_ms;
+    // Engine end to end (subdivider::refine_topology)
+    double cold_ms, warm_ms, stencil_ms;
+    long peak_rss_kb;
+    // Vertex cache (see acmr) in OpenSubdiv's order and with set_reorder, and the warm refinement with it
+    double acmr, reordered_acmr, reordered_ms;
+};
+
+// One pass through the pipeline stage by stage (the same steps subdivider::refine_topology takes),
+// keeping the fastest time of each stage over `repeats` passes.
+static void time_stages(bench_mesh& mesh, int level, int repeats, bench_result& result) {
+    typedef Far::TopologyDescriptor Descriptor;
+    result.descriptor_ms = result.refine_ms = result.interpolate_ms = result.extract_ms = 1e30;
+
+    for (int r = 0; r < repeats; r++) {
+        if (level == 0) {
+            bench_clock::time_point start = bench_clock::now();
+            std::vector<int> edges;
+            subdivider::edges_only(mesh.n_verts(), mesh.n_faces(), &mesh.faceVerts[0], &mesh.vertsPerFace[0], edges);
+            result.extract_ms = std::min(result.extract_ms, elapsed_ms(start));
+            result.descriptor_ms = result.refine_ms = result.interpolate_ms = 0.0;
+            continue;
+        }
+
+        // -------- Descriptor + TopologyRefiner --------
+        bench_clock::time_point start = bench_clock::now();
+        Descriptor desc;
+        desc.numVertices = mesh.n_verts();
+        desc.numFaces = mesh.n_faces();
+        desc.vertIndicesPerFace = &mesh.faceVerts[0];
+        desc.numVertsPerFace = &mesh.vertsPerFace[0];
+        Sdc::Options options;
+        options.SetVtxBoundaryInterpolation(Sdc::Options::VTX_BOUNDARY_EDGE_ONLY);
+        Far::TopologyRefiner* refiner = Far::TopologyRefinerFactory<Descriptor>::Create(desc,
+            Far::TopologyRefinerFactory<Descriptor>::Options(Sdc::SCHEME_CATMARK, options));
+        result.descriptor_ms = std::min(result.descriptor_ms, elapsed_ms(start));
+
+        // -------- RefineUniform --------
+        start = bench_clock::now();
+        Far::TopologyRefiner::UniformOptions refine_options(level);
+        refine_options.fullTopologyInLastLevel = true;
+        refiner->RefineUniform(refine_options);
+        result.refine_ms = std::min(result.refine_ms, elapsed_ms(start));
+
+        // -------- Interpolation (two level buffers, last level straight into the output) --------
+        start = bench_clock::now();
+        Far::PrimvarRefiner primvarRefiner(*refiner);
+        int largest = 0;
+        for (int l = 0; l < level; l++) {
+            largest = std::max(largest, refiner->GetLevel(l).GetNumVertices());
+        }
+        std::vector<Vertex> even(largest), odd(largest);
+        Vertex* levels[2] = { &even[0], &odd[0] };
+        for (int i = 0; i < mesh.n_verts(); i++) {
+            levels[0][i].SetPosition(mesh.verts[3 * i], mesh.verts[3 * i + 1], mesh.verts[3 * i + 2]);
+        }
+        for (int l = 1; l < level; l++) {
+            primvarRefiner.Interpolate(l, levels[(l - 1) & 1], levels[l & 1]);
+        }
+        std::vector<float> positions(3 * (size_t)refiner->GetLevel(level).GetNumVertices());
+        position_buffer last(&positions[0]);
+        primvarRefiner.Interpolate(level, levels[(level - 1) & 1], last);
+        result.interpolate_ms = std::min(result.interpolate_ms, elapsed_ms(start));
+
+        // -------- Edge and face extraction --------
+        start = bench_clock::now();
+        Far::TopologyLevel const& refLastLevel = refiner->GetLevel(level);
+        std::vector<int> edges(2 * (size_t)refLastLevel.GetNumEdges());
+        for (int i = 0; i < refLastLevel.GetNumEdges(); i++) {
+            Far::ConstIndexArray everts = refLastLevel.GetEdgeVertices(i);
+            edges[2 * i] = everts[0];
+            edges[2 * i + 1] = everts[1];
+        }
+        std::vector<int> faces;
+        faces.reserve(4 * (size_t)refLastLevel.GetNumFaces());
+        for (int i = 0; i < refLastLevel.GetNumFaces(); i++) {
+            Far::ConstIndexArray fverts = refLastLevel.GetFaceVertices(i);
+            faces.insert(faces.end(), fverts.begin(), fverts.end());
+        }
+        result.extract_ms = std::min(result.extract_ms, elapsed_ms(start));
+
+        delete refiner;
+    }
+}
+
+// The engine as the bindings use it: cold (cache off), warm (topology cache hit) and warm with stencils,
+// plus the copy-out into caller buffers.
+static void time_engine(bench_mesh& mesh, int level, int repeats, bench_result& result) {
+    subdivider engine;
+    engine.settings(level, false);
+    result.cold_ms = result.warm_ms = result.stencil_ms = result.copyout_ms = 1e30;
+
+    reset_peak_memory();
+    engine.set_cache_size(0);
+    for (int r = 0; r < repeats; r++) {
+        bench_clock::time_point start = bench_clock::now();
+        engine.refine_topology(mesh.n_verts(), mesh.n_faces(), mesh.vertices(), &mesh.faceVerts[0], &mesh.vertsPerFace[0]);
+        result.cold_ms = std::min(result.cold_ms, elapsed_ms(start));
+    }
+    result.peak_rss_kb = peak_memory_kb();
+
+    engine.set_cache_size(1);
+    engine.refine_topology(mesh.n_verts(), mesh.n_faces(), mesh.vertices(), &mesh.faceVerts[0], &mesh.vertsPerFace[0]);
+    for (int r = 0; r < repeats; r++) {
+        bench_clock::time_point start = bench_clock::now();
+        engine.refine_topology(mesh.n_verts(), mesh.n_faces(), mesh.vertices(), &mesh.faceVerts[0], &mesh.vertsPerFace[0]);
+        result.warm_ms = std::min(result.warm_ms, elapsed_ms(start));
+    }
+
+    result.verts_out = engine.nn_verts;
+    result.edges_out = engine.nn_edges;
+    result.faces_out = engine.nn_faces;
+    std::vector<float> vertices(3 * (size_t)engine.nn_verts + 1);
+    std::vector<int> edges(2 * (size_t)engine.nn_edges + 1);
+    std::vector<int> vertsPerFace(engine.nn_faces + 1);
+    std::vector<int> faceVerts(engine.nn_face_verts + 1);
+    for (int r = 0; r < repeats; r++) {
+        bench_clock::time_point start = bench_clock::now();
+        engine.export_mesh(&vertices[0], &edges[0], NULL);
+        engine.export_faces(&vertsPerFace[0], &faceVerts[0]);
+        result.copyout_ms = std::min(result.copyout_ms, elapsed_ms(start));
+    }
+    result.acmr = acmr(engine.nn_verts, engine.nn_faces, &vertsPerFace[0], &faceVerts[0]);
+
+    // -------- Cache-friendly order --------
+    engine.set_reorder(true);
+    engine.refine_topology(mesh.n_verts(), mesh.n_faces(), mesh.vertices(), &mesh.faceVerts[0], &mesh.vertsPerFace[0]);
+    result.reordered_ms = 1e30;
+    for (int r = 0; r < repeats; r++) {
+        bench_clock::time_point start = bench_clock::now();
+        engine.refine_topology(mesh.n_verts(), mesh.n_faces(), mesh.vertices(), &mesh.faceVerts[0], &mesh.vertsPerFace[0]);
+        result.reordered_ms = std::min(result.reordered_ms, elapsed_ms(start));
+    }
+    engine.export_faces(&vertsPerFace[0], &faceVerts[0]);
+    result.reordered_acmr = acmr(engine.nn_verts, engine.nn_faces, &vertsPerFace[0], &faceVerts[0]);
+    engine.set_reorder(false);
+
+    engine.set_stencils(true);
+    engine.refine_topology(mesh.n_verts(), mesh.n_faces(), mesh.vertices(), &mesh.faceVerts[0], &mesh.vertsPerFace[0]);
+    for (int r = 0; r < repeats; r++) {
+        bench_clock::time_point start = bench_clock::now();
+        engine.refine_topology(mesh.n_verts(), mesh.n_faces(), mesh.vertices(), &mesh.faceVerts[0], &mesh.vertsPerFace[0]);
+        result.stencil_ms = std::min(result.stencil_ms, elapsed_ms(start));
+    }
+}
+
+//---------------- Output ----------------
+static char const* const columns[] = {
+    "mesh", "level", "verts_in", "faces_in", "verts_out", "edges_out", "faces_out",
+    "descriptor_ms", "refine_ms", "interpolate_ms", "extract_ms", "copyout_ms",
+    "cold_ms", "warm_ms", "stencil_ms", "peak_rss_kb",
+    "acmr", "reordered_acmr", "reordered_ms"
+};
+static int const n_columns = sizeof(columns) / sizeof(columns[0]);
+
+static std::vector<std::string> values(bench_result const& r) {
+    double times[] = { r.descriptor_ms, r.refine_ms, r.interpolate_ms, r.extract_ms, r.copyout_ms, r.cold_ms, r.warm_ms, r.stencil_ms };
+    std::vector<std::string> row;
+    row.push_back(r.mesh);
+    long counts[] = { r.level, r.verts_in, r.faces_in, r.verts_out, r.edges_out, r.faces_out };
+    for (long count : counts) {
+        row.push_back(std::to_string(count));
+    }
+    for (double time : times) {
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), "%.4f", time);
+        row.push_back(buffer);
+    }
+    row.push_back(std::to_string(r.peak_rss_kb));
+    double extra[] = { r.acmr, r.reordered_acmr, r.reordered_ms };
+    for (double value : extra) {
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), "%.4f", value);
+        row.push_back(buffer);
+    }
+    return row;
+}
+
+static void write_csv(std::ostream& out, std::vector<bench_result> const& results) {
+    for (int c = 0; c < n_columns; c++) {
+        out << (c ? "," : "") << columns[c];
+    }
+    out << "\n";
+    for (bench_result const& r : results) {
+        std::vector<std::string> row = values(r);
+        for (int c = 0; c < n_columns; c++) {
+            out << (c ? "," : "") << row[c];
+        }
+        out << "\n";
+    }
+}
+
+static void write_json(std::ostream& out, std::vector<bench_result> const& results) {
+    out << "{\n  \"opensubdiv_version\": \"" << OPENSUBDIV_VERSION_STRING << "\",\n";
+    out << "  \"threads\": " << hardware_threads() << ",\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        std::vector<std::string> row = values(results[i]);
+        out << "    {";
+        for (int c = 0; c < n_columns; c++) {
+            out << (c ? ", " : "") << "\"" << columns[c] << "\": ";
+            if (c == 0) {
+                out << "\"" << row[c] << "\"";
+            } else {
+                out << row[c];
+            }
+        }
+        out << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+int main(int argc, char** argv) {
+    int max_level = 6;
+    int repeats = 3;
+    long max_faces = 4194304;
+    std::string filter, format = "csv", output;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "-l" && has_value) {
+            max_level = std::atoi(argv[++i]);
+        } else if (arg == "-r" && has_value) {
+            repeats = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "-m" && has_value) {
+            filter = argv[++i];
+        } else if (arg == "-x" && has_value) {
+            max_faces = std::atol(argv[++i]);
+        } else if (arg == "-f" && has_value) {
+            format = argv[++i];
+        } else if (arg == "-o" && has_value) {
+            output = argv[++i];
+        } else {
+            std::cerr << "unknown argument " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<bench_mesh> meshes;
+    for (benchmark_mesh const& table : benchmark_meshes) {
+        meshes.push_back(from_table(table));
+    }
+    meshes.push_back(grid(32));
+    meshes.push_back(grid(256));
+    meshes.push_back(torus(64, 32));
+    meshes.push_back(torus(512, 256));
+
+    std::vector<bench_result> results;
+    for (bench_mesh& mesh : meshes) {
+        if (!filter.empty() && mesh.name.find(filter) == std::string::npos) {
+            continue;
+        }
+        for (int level = 0; level <= max_level; level++) {
+            // Every refined level has (at most) 4x the faces of the one before (n-gons split into n at level 1)
+            double refined_faces = (double)mesh.faceVerts.size() * std::pow(4.0, std::max(level - 1, 0));
+            if (level > 0 && refined_faces > max_faces) {
+                std::cerr << "skipping " << mesh.name << " @ " << level << " (" << (long)refined_faces << " faces)" << std::endl;
+                break;
+            }
+            bench_result result;
+            result.mesh = mesh.name;
+            result.level = level;
+            result.verts_in = mesh.n_verts();
+            result.faces_in = mesh.n_faces();
+            time_stages(mesh, level, repeats, result);
+            time_engine(mesh, level, repeats, result);
+            results.push_back(result);
+            std::cerr << mesh.name << " @ " << level << ": " << result.cold_ms << " ms, ACMR " << result.acmr
+                      << " -> " << result.reordered_acmr << " reordered" << std::endl;
+        }
+    }
+
+    std::ofstream file;
+    if (!output.empty()) {
+        file.open(output.c_str());
+    }
+    std::ostream& out = output.empty() ? std::cout : file;
+    if (format == "json") {
+        write_json(out, results);
+    } else {
+        write_csv(out, results);
+    }
+    return 0;
+}
@@ -1,589 +1,4463 @@
-#include <iostream>
-#include <vector>
-#include <map>
-#include <algorithm>
-
-// This actually works? 
-// https://stackoverflow.com/a/25155315/2391876
-#ifdef _WIN32 // This is what Visual Studio defines 
-#define DLLEXPORT __declspec(dllexport)
-// This resolves the "M_PI (pi) is not defined properly" error. 
-// (https://stackoverflow.com/questions/6563810/m-pi-works-with-math-h-but-not-with-cmath-in-visual-studio)
-// There may be better approaches to this, but I'm not sure what. 
-// I also really feel like this should not be necessary, see OpenSubDiv -> CMakeLists.txt -> /D_USE_MATH_DEFINES. 
-#define _USE_MATH_DEFINES
-#include <math.h>
-#elif __linux__
-#define DLLEXPORT 
-#elif __APPLE__
-// [ ] Implement 
-#endif
-
-//---------------- Compile Instructions ----------------
-
-//-------- Windows - Visual Studio --------
-// 1) Download, compile, and install OpenSubdiv 
-//   -Install git 
-//   -Install CMake 
-//   -Install GLFW (https://www.glfw.org/download) (I don't think you actually need this, but it might make certain parts smoother?)
-//     - Download the windows 64 precompiled binaries. 
-//     - In the unzipped folder, make a new directory 'lib', put all the lib files for your Visual Studio version in there, e.g. move everything in /lib-vc2022 to /lib
-//   - Clone opensubdiv repo. 
-//   - cd into OpenSubdiv repo, mkdir build, cd build.  
-//   - Build Step 1, Initial build: 
-//
-//       cmake ^
-//           -G "Visual Studio 15 2017 Win64" ^
-//           -D NO_PTEX=1 -D NO_DOC=1 ^
-//           -D NO_OMP=1 -D NO_TBB=1 -D NO_CUDA=1 -D NO_OPENCL=1 -D NO_CLEW=1 ^
-//           -D "GLFW_LOCATION=*YOUR GLFW INSTALL LOCATION*" ^
-//           ..
-//
-//   - You MUST specify the architecture (x64), or else it tries to build with x86 Windows libraries, or something. 
-//   - See: https://github.com/PixarAnimationStudios/OpenSubdiv/issues/1245
-//   - DO NOT have MSYS installed. Somehow CMake seeks it out and finds it, and the build process doesn't go well. 
-//   - The exact build command I used was (vary appropriately for paths, e.g. glfw, and Visual Studio Version) 
-// 
-//      cmake ^ -DCMAKE_GENERATOR_PLATFORM=x64 -G "Visual Studio 17 2022" ^ -D NO_PTEX=1 -D NO_DOC=1 ^ -D NO_OMP=1 -D NO_TBB=1 -D NO_CUDA=1 -D NO_OPENCL=1 -D NO_CLEW=1 ^ -D "GLFW_LOCATION=C:/Users/<username>/Desktop/cpp/glfw-3.3.7.bin.WIN64/glfw-3.3.7.bin.WIN64" ^ ..
-// 
-//   - Build Step 2, Install build (run this in an administrator console): 
-// 
-//       cmake --build . --config Release --target install
-// 
-//   - Should create bin, include, and lib directores under C:\Program Files\OpenSubdiv
-//
-// 2) Create and Configure Visual Studio Project 
-//  - Create a new blank C++ project in Visual Studio (Note: NOT visual studio CODE, but actually Microsoft Visual Studio)
-//  - Create a blank Source.cpp file under "Source Files"
-//  - Configure the solution properties (All builds, All Platforms):
-//      - Add OpenSubdiv include to additional include directories: 
-//          - Properties -> C/C++ -> General -> Additional Include Directores -> C:\Program Files\OpenSubdiv\include
-//      - Add OpenSubdiv libs to additional Library directories:
-//          - Properties -> Linker -> General -> Additional Library Directories -> C:\Program Files\OpenSubdiv\lib
-//      - Add OpenSubdiv library binaries to linker's Additional Dependencies (https://stackoverflow.com/questions/42867030/c-dll-unresolved-external-symbol/42867190#42867190):
-//          - Properties -> Linker -> Input -> Additional Dependencies -> osdCPU.lib;osdGPU.lib
-//          - This resolves the "unresolved external" at compile time.
-//      - Compile DLL: Properties -> Configuration Properties -> Configuration Type -> Dynamic Library (.dll)
-//  - You also need to prefix all of the C-wrapped functions (everything in extern "C") with '__declspec(dllexport)', 
-//      otherwise python won't be able to find the functions from the imported .dll. I'm 100% sure why this isn't necessary on linux. 
-
-//---------------- Vertex container implementation. ----------------
-struct Vertex {
-    // Minimal required interface ----------------------
-    Vertex() { }
-
-    Vertex(Vertex const& src) {
-        _position[0] = src._position[0];
-        _position[1] = src._position[1];
-        _position[2] = src._position[2];
-    }
-
-    void Clear(void* = 0) {
-        _position[0] = _position[1] = _position[2] = 0.0f;
-    }
-
-    void AddWithWeight(Vertex const& src, float weight) {
-        _position[0] += weight * src._position[0];
-        _position[1] += weight * src._position[1];
-        _position[2] += weight * src._position[2];
-    }
-
-    void SetPosition(float x, float y, float z) {
-        _position[0] = x;
-        _position[1] = y;
-        _position[2] = z;
-    }
-
-    const float* GetPosition() const {
-        return _position;
-    }
-
-private:
-    float _position[3];
-};
-
-//---------------- OpenSubdiv ----------------
-#include <opensubdiv/far/topologyDescriptor.h>
-#include <opensubdiv/far/primvarRefiner.h>
-using namespace OpenSubdiv;
-class subdivider {
-private:
-    void reset() {
-        // Need to do this otherwise these values end up growing as you do subdivisions on top of each other
-        new_vertices.clear();
-        new_edges.clear();
-        edge_list.clear();
-        new_faces.clear();
-    }
-    
-    void add_edge(int& origin, int& endpoint) {
-        bool origin_search_for_endpoint = false;
-        for (int i = 0; i < new_edges[origin].size(); i++) {
-            if (new_edges[origin][i] == endpoint) {
-                // std::cout << edges[origin][i] << std::endl;   
-                origin_search_for_endpoint = true;
-                break;
-            }
-        }
-
-        bool endpoint_search_for_origin = false;
-        if (not origin_search_for_endpoint) {
-            for (int i = 0; i < new_edges[endpoint].size(); i++) {
-                if (new_edges[endpoint][i] == origin) {
-                    // std::cout << edges[endpoint][i] << std::endl;
-                    endpoint_search_for_origin = true;
-                    break;
-                }
-            }
-        }
-
-        if (not origin_search_for_endpoint && not endpoint_search_for_origin) {
-            new_edges[origin].push_back({ endpoint });
-        }
-    }
-
-    std::vector<std::vector<int>> edges_to_list() {
-        for (int i = 0; i < new_edges.size(); i++) {
-            for (int j = 0; j < new_edges[i].size(); j++) {
-                edge_list.push_back(std::vector<int>({ i,new_edges[i][j] }));
-            }
-        }
-        return edge_list;
-    }
-
-public:
-    subdivider() {        
-        nn_verts = 0;
-        nn_edges = 0;
-        nn_faces = 0;
-        new_vertices.clear();
-        new_edges.clear();
-        edge_list.clear();
-        new_faces.clear();
-    }
-
-    int maxlevel = 0; 
-    int verbose = false; 
-
-    // outgoing topology 
-    int nn_verts;
-    int nn_edges;
-    int nn_faces;
-    std::vector<std::vector<float>> new_vertices;
-    std::vector<std::vector<int>> new_edges;
-    std::vector<std::vector<int>> edge_list;
-    std::vector<std::vector<int>> new_faces;
-
-    // ---------------- Configure ----------------
-    void settings(int maxlevel,int verbose){
-        if(maxlevel < 0){
-            maxlevel = 0;
-        }
-        this->maxlevel = maxlevel;
-        this->verbose = verbose;
-    }
-
-    // ---------------- Misc ----------------
-    void print_settings(){
-        std::cout << maxlevel << std::endl;
-        std::cout << verbose << std::endl;
-    }
-
-    // ---------------- Return new mesh info ----------------
-    std::vector<int> refinement_info() {
-        std::vector<int> info;
-        info.reserve(3);
-        info.push_back(nn_verts);
-        info.push_back(nn_edges);
-        info.push_back(nn_faces);
-        return info;
-    }
-
-    // ---------------- Return New Vertices ----------------
-    void return_new_vertices(float py_new_vertices[][3]) {
-        for (int i = 0; i < nn_verts; i++) {
-            py_new_vertices[i][0] = new_vertices[i][0];
-            py_new_vertices[i][1] = new_vertices[i][1];
-            py_new_vertices[i][2] = new_vertices[i][2];
-        }
-    }
-
-    // ---------------- Return New Edges ----------------
-    void return_new_edges(int py_new_edges[][2]) {
-        for (int i = 0; i < nn_edges; i++) {
-            py_new_edges[i][0] = edge_list[i][0];
-            py_new_edges[i][1] = edge_list[i][1];      
-        }
-    }
-    // ---------------- Return New Faces ----------------
-    // void return_new_faces(int **py_new_faces) {
-    void return_new_faces(int py_new_faces[][4]) {    
-        for (int i = 0; i < nn_faces; i++) {
-            py_new_faces[i][0] = new_faces[i][0];
-            py_new_faces[i][1] = new_faces[i][1];
-            py_new_faces[i][2] = new_faces[i][2];
-            py_new_faces[i][3] = new_faces[i][3];
-        }
-
-        // std::vector<int*> new_faces_vector;
-        
-        // for(int i=0;i<new_faces.size();i++){
-        //     new_faces_vector.push_back(new_faces[i].data());
-        // };
-
-        // py_new_faces = new_faces_vector.data();
-
-        // if(1){        
-        //     for(int i=0;i<new_faces.size();i++){
-        //         for(int j=0;j<new_faces[i].size();j++){
-        //             std::cout << py_new_faces[i][j] << " ";
-        //         }
-        //         std::cout << std::endl;
-        //     };
-        // };
-    }
-
-    // ---------------- Only Create edges from faces ----------------
-    void edges_only(int n_verts, int n_faces, int* faceVerts, int* vertsPerFace){
-        // ---- New Edges and Faces ----
-        int origin = 0;
-        int endpoint = 0;
-        // Each vert MAY be connected to another 
-        new_edges.resize(n_verts);
-
-        int arr_pos = 0;
-        for(int i=0;i<n_faces;i++){            
-            for(int j=0;j<vertsPerFace[i];j++){
-                origin = faceVerts[arr_pos+j];
-                endpoint = faceVerts[arr_pos+(j+1)%vertsPerFace[i]];
-                // if(verbose){
-                //     printf("%d->%d ", origin, endpoint);
-                // }
-                add_edge(origin, endpoint);
-            }
-            arr_pos = arr_pos + vertsPerFace[i];
-            // if(verbose){std::cout << std::endl;}
-        }
-
-        edge_list = edges_to_list();
-        nn_edges = edge_list.size();
-    }
-
-    // ---------------- Refine Topology ----------------
-    void refine_topology(int n_verts, int n_faces, float vertices[][3], int* faceVerts, int* vertsPerFace) {
-        reset();
-
-        if(verbose){                
-            std::cout << "maxlevel " << maxlevel << std::endl;
-        }
-
-        if(maxlevel == 0){
-            edges_only(n_verts, n_faces, faceVerts, vertsPerFace);
-            if(verbose){
-                std::cout << "New Vertices " << n_verts << std::endl;
-                for(int i=0;i<n_verts;i++){
-                    printf("v %f %f %f\n", vertices[i][0], vertices[i][1], vertices[i][2]);
-                }
-                for(int i = 0; i < edge_list.size(); i++) {
-                    printf("e %d %d\n", edge_list[i][0], edge_list[i][1]);
-                }
-                int arr_pos = 0;
-                for(int i=0;i<n_faces;i++){
-                    std::cout << "f ";
-                    for(int j=0;j<vertsPerFace[i];j++){
-                        // Legacy OBJ vert inds start at 1 (see end of this function)
-                        std::cout << faceVerts[arr_pos+j]+1 << " ";
-                    }
-                    arr_pos = arr_pos + vertsPerFace[i];
-                    std::cout << std::endl;
-                }
-                return;
-            }
-            return;
-        }        
-
-        typedef Far::TopologyDescriptor Descriptor;
-        Descriptor desc;
-
-        desc.numVertices = n_verts;
-        desc.numFaces = n_faces;
-        desc.vertIndicesPerFace = faceVerts;
-        desc.numVertsPerFace = vertsPerFace;
-
-        // -------- Configure Refiner --------
-        Sdc::SchemeType type = OpenSubdiv::Sdc::SCHEME_CATMARK;
-        Sdc::Options options;
-        options.SetVtxBoundaryInterpolation(Sdc::Options::VTX_BOUNDARY_EDGE_ONLY);
-
-        // Instantiate a Far::TopologyRefiner from the descriptor (and refinement options) 
-        Far::TopologyRefiner* refiner = Far::TopologyRefinerFactory<Descriptor>::Create(desc, Far::TopologyRefinerFactory<Descriptor>::Options(type, options));
-
-        // Uniformly refine the topology up to "maxlevel" 
-        refiner->RefineUniform(Far::TopologyRefiner::UniformOptions(maxlevel));
-
-        // -------- Vertices --------
-        std::vector<Vertex> vbuffer(refiner->GetNumVerticesTotal());
-        Vertex* verts_course = &vbuffer[0];        
-
-        for (int i = 0; i < desc.numVertices; i++) {
-            verts_course[i].SetPosition(vertices[i][0], vertices[i][1], vertices[i][2]);
-        }
-
-        
-
-        // -------- Interpolate vertex primvar data --------
-        Far::PrimvarRefiner primvarRefiner(*refiner);
-        Vertex* src = verts_course;
-
-        for (int level = 1; level <= maxlevel; ++level) {
-            Vertex* dst = src + refiner->GetLevel(level - 1).GetNumVertices();
-            primvarRefiner.Interpolate(level, src, dst);
-            src = dst;
-        }
-
-        // -------- Set Results --------
-        // ---- New Vertices ----
-        // This renames refiner->GetLevel(maxlevel) basically (to refLastLevel)
-        Far::TopologyLevel const& refLastLevel = refiner->GetLevel(maxlevel); // refLastLevel = address of refiner->GetLevel(maxlevel)
-        // int nn_verts = refLastLevel.GetNumVertices();
-        nn_verts = refLastLevel.GetNumVertices();
-
-        int firstOfLastVerts = refiner->GetNumVerticesTotal() - nn_verts;
-
-        new_vertices.reserve(nn_verts);
-        for (int i = 0; i < nn_verts; i++) {
-            float const* pos = verts_course[firstOfLastVerts + i].GetPosition();
-            // if (verbose) {
-            //     printf("v %f %f %f\n", pos[0], pos[1], pos[2]);
-            // }
-            new_vertices.push_back(std::vector<float>(pos, pos + 3));
-        }
-
-        // ---- New Edges and Faces ----
-        int origin = 0;
-        int endpoint = 0;
-        // Each vert MAY be connected to another 
-        // new_edges.reserve(nn_verts); // This would be nice but actually complicates things 
-        new_edges.resize(nn_verts);
-
-        // int nn_faces = refLastLevel.GetNumFaces();
-        nn_faces = refLastLevel.GetNumFaces();
-        new_faces.reserve(nn_faces);
-
-        for (int i = 0; i < nn_faces; i++) {
-            Far::ConstIndexArray fverts = refLastLevel.GetFaceVertices(i);
-            // All refined CatMark faces should be quads.
-            // Only true if maxlevel > 0, though. 
-            assert(fverts.size() == 4); 
-            new_faces.push_back(std::vector<int>({ fverts[0],fverts[1],fverts[2],fverts[3] }));
-
-            for (int j = 0; j < fverts.size(); j++) {
-                origin = fverts[j];
-                endpoint = fverts[(j + 1) % fverts.size()];
-                add_edge(origin, endpoint);
-            }
-        }
-
-        edge_list = edges_to_list();
-        nn_edges = edge_list.size();
-
-        if (verbose) {
-            std::cout << "New Vertices " << nn_verts << std::endl;
-
-            // This outputs "legacy" obj format (at least, as Blender calls it)
-            // I don't know what the modern format is supposed to look like, 
-            // but with this version, vertex indices start at 1, NOT 0. 
-            // NOTE also that Blender applies the Z-up, Y-forward convention,
-            // so remember to set that when importing the obj. 
-            // Otherwise, it comes out rotated.             
-            for (int i = 0; i < nn_verts; i++) {
-                printf("v %f %f %f\n", new_vertices[i][0],new_vertices[i][1],new_vertices[i][2]);
-            }
-            // for (int i = 0; i < new_edges.size(); i++) {
-            //     std::cout << i << ": ";
-            //     for (int j = 0; j < new_edges[i].size(); j++) {
-            //         std::cout << new_edges[i][j] << " ";
-            //     }
-            //     std::cout << std::endl;
-            // }
-            for (int i = 0; i < edge_list.size(); i++) {
-                printf("e %d %d\n", edge_list[i][0], edge_list[i][1]);
-            }
-            for (int i = 0; i < nn_faces; i++) {
-                printf("f %d %d %d %d\n", new_faces[i][0]+1, new_faces[i][1]+1, new_faces[i][2]+1, new_faces[i][3]+1);
-            }
-        }
-    }
-};
-
-int main(int argc, char** argv) {
-    // Example usage: ./ctypes_OpenSubdiv -l 3 -v
-    // Defaults 
-    int subdivision_level = 0; 
-    int verbose = false; 
-
-    for(int i = 0; i < argc; i++){        
-        std::map<std::string,int> arg_map; 
-        arg_map.insert(std::pair<std::string,int>("-l",1));
-        arg_map.insert(std::pair<std::string,int>("-v",2));
-
-        switch(arg_map[argv[i]]) {
-            case 1:                                          
-                // subdivision_level = std::stoi(argv[i+1]); // Windows doesn't like stoi *shrugs*
-                subdivision_level = std::atoi(argv[i+1]);
-                i++;
-                break;
-            case 2: 
-                verbose = true; 
-                break;
-        }
-    }
-
-    // Cube geometry from catmark_cube.h
-    // static float g_verts[8][3] = { { -0.5f, -0.5f,  0.5f },
-    //                             {  0.5f, -0.5f,  0.5f },
-    //                             { -0.5f,  0.5f,  0.5f },
-    //                             {  0.5f,  0.5f,  0.5f },
-    //                             { -0.5f,  0.5f, -0.5f },
-    //                             {  0.5f,  0.5f, -0.5f },
-    //                             { -0.5f, -0.5f, -0.5f },
-    //                             {  0.5f, -0.5f, -0.5f } };
-
-    // static int g_nverts = 8, g_nfaces = 6;
-
-    // static int g_vertsperface[6] = { 4, 4, 4, 4, 4, 4 };
-
-    // static int g_vertIndices[24] = { 0, 1, 3, 2,
-    //                                 2, 3, 5, 4,
-    //                                 4, 5, 7, 6,
-    //                                 6, 7, 1, 0,
-    //                                 1, 7, 5, 3,
-    //                                 6, 0, 2, 4 };
-
-    // Triangle array (for testing non-quads)
-    // static float g_verts[10][3]  = { {-0.75, -1.7320507764816284, 0.0},
-    //                                 {-2.25, -0.8660253882408142, 0.0},
-    //                                 {-2.25, 0.8660253882408142, 0.0},
-    //                                 {0.75, 0.8660253882408142, 0.0},
-    //                                 {-0.75, -1.1102230246251565e-16, 0.0},
-    //                                 {-0.75, 1.7320507764816284, 0.0},
-    //                                 {2.25, -1.7320507764816284, 0.0},
-    //                                 {0.75, -0.8660253882408142, 0.0},
-    //                                 {2.25, 1.7320507764816284, 0.0},
-    //                                 {2.25, 1.1102230246251565e-16, 0.0} };
-
-    // static int g_nverts = 10, g_nfaces = 9;
-
-    // static int g_vertsperface[9] = {3, 3, 3, 3, 3, 3, 3, 3, 3};
-
-    // static int g_vertIndices[27] = { 4, 0, 1, 
-    //                                 1, 2, 4, 
-    //                                 5, 4, 2, 
-    //                                 0, 4, 7, 
-    //                                 3, 7, 4, 
-    //                                 4, 5, 3, 
-    //                                 9, 6, 7, 
-    //                                 7, 3, 9, 
-    //                                 8, 9, 3 };
-
-    // Ngons 
-    // static float g_verts[33][3] = { {8.00f, 0.00f, 0.00f},
-    // {5.66f, 5.66f, 0.00f},
-    // {0.00f, 8.00f, 0.00f},
-    // {-5.66f, 5.66f, 0.00f},
-    // {-8.00f, 0.00f, 0.00f},
-    // {-5.66f, -5.66f, 0.00f},
-    // {-0.00f, -8.00f, 0.00f},
-    // {5.66f, -5.66f, 0.00f},
-    // {7.00f, 0.00f, 0.00f},
-    // {4.36f, 5.47f, 0.00f},
-    // {-1.56f, 6.82f, 0.00f},
-    // {-6.31f, 3.04f, 0.00f},
-    // {-6.31f, -3.04f, 0.00f},
-    // {-1.56f, -6.82f, 0.00f},
-    // {4.36f, -5.47f, 0.00f},
-    // {6.00f, 0.00f, 0.00f},
-    // {3.00f, 5.20f, 0.00f},
-    // {-3.00f, 5.20f, 0.00f},
-    // {-6.00f, 0.00f, 0.00f},
-    // {-3.00f, -5.20f, 0.00f},
-    // {3.00f, -5.20f, 0.00f},
-    // {5.00f, 0.00f, 0.00f},
-    // {1.55f, 4.76f, 0.00f},
-    // {-4.05f, 2.94f, 0.00f},
-    // {-4.05f, -2.94f, 0.00f},
-    // {1.55f, -4.76f, 0.00f},
-    // {4.00f, 0.00f, 0.00f},
-    // {0.00f, 4.00f, 0.00f},
-    // {-4.00f, 0.00f, 0.00f},
-    // {-0.00f, -4.00f, 0.00f},
-    // {3.00f, 0.00f, 0.00f},
-    // {-1.50f, 2.60f, 0.00f},
-    // {-1.50f, -2.60f, 0.00f} };
-
-    // static int g_nverts = 33, g_nfaces = 6;
-
-    // static int g_vertsperface[6] = {8, 7, 6, 5, 4, 3};
-
-    // static int g_vertIndices[33] = {
-    // 0, 1, 2, 3, 4, 5, 6, 7,
-    // 8, 9, 10, 11, 12, 13, 14,
-    // 15, 16, 17, 18, 19, 20,
-    // 21, 22, 23, 24, 25,
-    // 26, 27, 28, 29,
-    // 30, 31, 32 };
-
-    // ngons_2
-    static float g_verts[7][3] = { {-1.00f, -1.00f, 0.00f},
-    {1.00f, -1.00f, 0.00f},
-    {-1.00f, 1.00f, 0.00f},
-    {1.00f, 1.00f, 0.00f},
-    {1.73f, 0.16f, 1.75f},
-    {-1.73f, 1.00f, 1.75f},
-    {0.00f, 1.00f, 2.51f} };
-
-    static int g_nverts = 7, g_nfaces = 3;
-
-    static int g_vertsperface[3] = {5, 4, 3};
-
-    static int g_vertIndices[12] = {
-    2, 3, 4, 6, 5,
-    0, 1, 3, 2,
-    4, 3, 1 };
-
-    subdivider subdivider_instance;    
-    subdivider_instance.settings(subdivision_level,verbose);
-    subdivider_instance.print_settings();
-
-    subdivider_instance.refine_topology(g_nverts, g_nfaces, g_verts, g_vertIndices, g_vertsperface);
-
-    return 0;
-}
-
-extern "C"
-{
-    subdivider subdivider_new;    
-
-    DLLEXPORT void subdivider_settings(int maxlevel, int verbose) {subdivider_new.settings(maxlevel,verbose);}
-
-    // DLLEXPORT void subdivider_refine_topology(int maxlevel, int verbose, int n_verts, int n_faces, float vertices[][3], int* faceVerts, int* vertsPerFace) { subdivider_new.refine_topology(maxlevel, verbose, n_verts, n_faces, vertices, faceVerts, vertsPerFace); }
-
-    DLLEXPORT void subdivider_refine_topology(int n_verts, int n_faces, float vertices[][3], int* faceVerts, int* vertsPerFace) { subdivider_new.refine_topology(n_verts, n_faces, vertices, faceVerts, vertsPerFace); }    
-
-    DLLEXPORT int nn_verts() { return subdivider_new.nn_verts; }
-    DLLEXPORT int nn_edges() { return subdivider_new.nn_edges; }
-    DLLEXPORT int nn_faces() { return subdivider_new.nn_faces; }
-
-    DLLEXPORT void new_vertices(float py_new_vertices[][3]) { subdivider_new.return_new_vertices(py_new_vertices); }
-    DLLEXPORT void new_edges(int py_new_edges[][2]) { subdivider_new.return_new_edges(py_new_edges); }
-    DLLEXPORT void new_faces(int py_new_faces[][4]) { subdivider_new.return_new_faces(py_new_faces); }
-
-    // This technically works but doesn't return anything back to python,
-    // even though I would expect py_new_faces to be passed by reference. 
-    // Confused. 
-    // Separate issue that each row of the matrix can have different length
-    // (each face may have an arbitrary number of verts),
-    // which seems really hard to implement on the ctypes side, if possible at all. 
-    // DLLEXPORT void new_faces(int **py_new_faces) { subdivider_new.return_new_faces(py_new_faces); }    
-
-}
\ No newline at end of file
+#include <iostream>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <list>
+#include <memory>
+#include <stdint.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <chrono>
+
+// This actually works? 
+// https://stackoverflow.com/a/25155315/2391876
+#ifdef _WIN32 // This is what Visual Studio defines 
+#define DLLEXPORT __declspec(dllexport)
+// This resolves the "M_PI (pi) is not defined properly" error. 
+// (https://stackoverflow.com/questions/6563810/m-pi-works-with-math-h-but-not-with-cmath-in-visual-studio)
+// There may be better approaches to this, but I'm not sure what. 
+// I also really feel like this should not be necessary, see OpenSubDiv -> CMakeLists.txt -> /D_USE_MATH_DEFINES. 
+#define _USE_MATH_DEFINES
+#include <math.h>
+#elif __linux__
+#define DLLEXPORT 
+#elif __APPLE__
+// [ ] Implement 
+#endif
+
+//---------------- Compile Instructions ----------------
+
+//-------- Windows - Visual Studio --------
+// 1) Download, compile, and install OpenSubdiv 
+//   -Install git 
+//   -Install CMake 
+//   -Install GLFW (https://www.glfw.org/download) (I don't think you actually need this, but it might make certain parts smoother?)
+//     - Download the windows 64 precompiled binaries. 
+//     - In the unzipped folder, make a new directory 'lib', put all the lib files for your Visual Studio version in there, e.g. move everything in /lib-vc2022 to /lib
+//   - Clone opensubdiv repo. 
+//   - cd into OpenSubdiv repo, mkdir build, cd build.  
+//   - Build Step 1, Initial build: 
+//
+//       cmake ^
+//           -G "Visual Studio 15 2017 Win64" ^
+//           -D NO_PTEX=1 -D NO_DOC=1 ^
+//           -D NO_OMP=1 -D NO_TBB=1 -D NO_CUDA=1 -D NO_OPENCL=1 -D NO_CLEW=1 ^
+//           -D "GLFW_LOCATION=*YOUR GLFW INSTALL LOCATION*" ^
+//           ..
+//
+//   - You MUST specify the architecture (x64), or else it tries to build with x86 Windows libraries, or something. 
+//   - See: https://github.com/PixarAnimationStudios/OpenSubdiv/issues/1245
+//   - DO NOT have MSYS installed. Somehow CMake seeks it out and finds it, and the build process doesn't go well. 
+//   - The exact build command I used was (vary appropriately for paths, e.g. glfw, and Visual Studio Version) 
+// 
+//      cmake ^ -DCMAKE_GENERATOR_PLATFORM=x64 -G "Visual Studio 17 2022" ^ -D NO_PTEX=1 -D NO_DOC=1 ^ -D NO_OMP=1 -D NO_TBB=1 -D NO_CUDA=1 -D NO_OPENCL=1 -D NO_CLEW=1 ^ -D "GLFW_LOCATION=C:/Users/<username>/Desktop/cpp/glfw-3.3.7.bin.WIN64/glfw-3.3.7.bin.WIN64" ^ ..
+// 
+//   - Build Step 2, Install build (run this in an administrator console): 
+// 
+//       cmake --build . --config Release --target install
+// 
+//   - Should create bin, include, and lib directores under C:\Program Files\OpenSubdiv
+//
+// 2) Create and Configure Visual Studio Project 
+//  - Create a new blank C++ project in Visual Studio (Note: NOT visual studio CODE, but actually Microsoft Visual Studio)
+//  - Create a blank Source.cpp file under "Source Files"
+//  - Configure the solution properties (All builds, All Platforms):
+//      - Add OpenSubdiv include to additional include directories: 
+//          - Properties -> C/C++ -> General -> Additional Include Directores -> C:\Program Files\OpenSubdiv\include
+//      - Add OpenSubdiv libs to additional Library directories:
+//          - Properties -> Linker -> General -> Additional Library Directories -> C:\Program Files\OpenSubdiv\lib
+//      - Add OpenSubdiv library binaries to linker's Additional Dependencies (https://stackoverflow.com/questions/42867030/c-dll-unresolved-external-symbol/42867190#42867190):
+//          - Properties -> Linker -> Input -> Additional Dependencies -> osdCPU.lib;osdGPU.lib
+//          - This resolves the "unresolved external" at compile time.
+//      - Compile DLL: Properties -> Configuration Properties -> Configuration Type -> Dynamic Library (.dll)
+//  - You also need to prefix all of the C-wrapped functions (everything in extern "C") with '__declspec(dllexport)', 
+//      otherwise python won't be able to find the functions from the imported .dll. I'm 100% sure why this isn't necessary on linux. 
+
+//---------------- SIMD ----------------
+// SSE2 is there on every x86-64 build, AVX only if the build enables it (-mavx, -march=native, ...). 
+// The stencil kernels further down also have AVX2 + FMA versions, picked at runtime (GCC/Clang only). 
+// Anything else (ARM, ...) gets the scalar loops. 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SUBDIVIDER_SSE 1
+#endif
+#if defined(SUBDIVIDER_SSE) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define SUBDIVIDER_AVX2_DISPATCH 1
+#endif
+
+// dst[0, N) += weight * src[0, N), for 16 byte aligned arrays padded to whole registers (see VertexT). 
+// The specializations are picked at compile time, the scalar loop is the fallback. 
+template <typename Real, int N>
+struct accumulate {
+    static void run(Real* dst, Real const* src, float weight) {
+        for (int k = 0; k < N; k++) {
+            dst[k] += weight * src[k];
+        }
+    }
+};
+
+#ifdef SUBDIVIDER_SSE
+template <int N>
+struct accumulate<float, N> {
+    static void run(float* dst, float const* src, float weight) {
+        __m128 w = _mm_set1_ps(weight);
+        for (int k = 0; k < N; k += 4) {
+            _mm_store_ps(dst + k, _mm_add_ps(_mm_load_ps(dst + k), _mm_mul_ps(_mm_load_ps(src + k), w)));
+        }
+    }
+};
+
+template <int N>
+struct accumulate<double, N> {
+    static void run(double* dst, double const* src, float weight) {
+        int k = 0;
+#ifdef __AVX__
+        __m256d w4 = _mm256_set1_pd(weight);
+        for (; k + 4 <= N; k += 4) {
+            _mm256_storeu_pd(dst + k, _mm256_add_pd(_mm256_loadu_pd(dst + k), _mm256_mul_pd(_mm256_loadu_pd(src + k), w4)));
+        }
+#endif
+        __m128d w = _mm_set1_pd(weight);
+        for (; k < N; k += 2) {
+            _mm_store_pd(dst + k, _mm_add_pd(_mm_load_pd(dst + k), _mm_mul_pd(_mm_load_pd(src + k), w)));
+        }
+    }
+};
+#endif
+
+//---------------- Vertex container implementation. ----------------
+// N components of type Real (float, or double for large meshes where float drift shows at level 4+). 
+// The components are padded to whole SSE registers (4 floats, 2 doubles), so AddWithWeight, 
+// which PrimvarRefiner calls for every weight of every refined vertex, is a couple of multiply-adds. 
+template <typename Real, int N>
+struct VertexT {
+    enum { lanes = 16 / sizeof(Real), size = (N + lanes - 1) / lanes * lanes };
+
+    // Minimal required interface ----------------------
+    VertexT() { }
+
+    VertexT(VertexT const& src) {
+        std::copy(src._data, src._data + size, _data);
+    }
+
+    void Clear(void* = 0) {
+        std::fill(_data, _data + size, Real(0));
+    }
+
+    void AddWithWeight(VertexT const& src, float weight) {
+        accumulate<Real, size>::run(_data, src._data, weight);
+    }
+
+    void SetPosition(Real x, Real y, Real z) {
+        std::fill(_data, _data + size, Real(0));
+        _data[0] = x;
+        _data[1] = y;
+        _data[2] = z;
+    }
+
+    const Real* GetPosition() const {
+        return _data;
+    }
+
+private:
+    alignas(16) Real _data[size];
+};
+
+typedef VertexT<float, 3> Vertex;
+typedef VertexT<double, 3> VertexD;
+
+//---------------- OpenSubdiv ----------------
+#include <opensubdiv/far/topologyDescriptor.h>
+#include <opensubdiv/far/primvarRefiner.h>
+#include <opensubdiv/far/stencilTableFactory.h>
+#include <opensubdiv/far/patchTableFactory.h>
+#include <opensubdiv/far/patchMap.h>
+#include <opensubdiv/far/ptexIndices.h>
+#include <opensubdiv/version.h>
+using namespace OpenSubdiv;
+
+//---------------- Stencil evaluation ----------------
+// A stencil table factorized down to the last level maps the control vertices straight 
+// to the refined vertices, i.e. every refined vertex is a weighted sum of control vertices. 
+// Applying it is a sparse gather, which skips all the intermediate levels. 
+
+// Raw view of a Far::StencilTable (sizes/offsets/indices/weights arrays)
+struct stencil_view {
+    stencil_view() : n_stencils(0), sizes(NULL), offsets(NULL), indices(NULL), weights(NULL) { }
+    explicit stencil_view(Far::StencilTable const& table) 
+        : n_stencils(table.GetNumStencils()), 
+          sizes(table.GetSizes().empty() ? NULL : &table.GetSizes()[0]), 
+          offsets(table.GetOffsets().empty() ? NULL : &table.GetOffsets()[0]), 
+          indices(table.GetControlIndices().empty() ? NULL : &table.GetControlIndices()[0]), 
+          weights(table.GetWeights().empty() ? NULL : &table.GetWeights()[0]) { }
+
+    int n_stencils;
+    int const* sizes;
+    int const* offsets;
+    int const* indices;
+    float const* weights;
+};
+
+// Gathers stencils [begin, end) into contiguous float3 output. 
+// The control points are padded to 4 floats (x, y, z, 0), so each one is a single 4-wide load/multiply-add. 
+static void gather_stencils_baseline(stencil_view const& stencils, float const* control4, float* dst3, int begin, int end) {
+    for (int i = begin; i < end; i++) {
+        int const* index = stencils.indices + stencils.offsets[i];
+        float const* weight = stencils.weights + stencils.offsets[i];
+        int size = stencils.sizes[i];
+        float* dst = dst3 + 3 * (size_t)i;
+#ifdef SUBDIVIDER_SSE
+        __m128 sum = _mm_setzero_ps();
+        for (int j = 0; j < size; j++) {
+            __m128 src = _mm_loadu_ps(control4 + 4 * (size_t)index[j]);
+            sum = _mm_add_ps(sum, _mm_mul_ps(src, _mm_set1_ps(weight[j])));
+        }
+        _mm_storel_pi((__m64*)dst, sum);
+        _mm_store_ss(dst + 2, _mm_movehl_ps(sum, sum));
+#else
+        float x = 0.0f, y = 0.0f, z = 0.0f;
+        for (int j = 0; j < size; j++) {
+            float const* src = control4 + 4 * (size_t)index[j];
+            x += weight[j] * src[0];
+            y += weight[j] * src[1];
+            z += weight[j] * src[2];
+        }
+        dst[0] = x;
+        dst[1] = y;
+        dst[2] = z;
+#endif
+    }
+}
+
+// Same in double precision, control points padded to 4 doubles 
+static void gather_stencils_baseline(stencil_view const& stencils, double const* control4, double* dst3, int begin, int end) {
+    for (int i = begin; i < end; i++) {
+        int const* index = stencils.indices + stencils.offsets[i];
+        float const* weight = stencils.weights + stencils.offsets[i];
+        int size = stencils.sizes[i];
+        double* dst = dst3 + 3 * (size_t)i;
+#ifdef SUBDIVIDER_SSE
+        __m128d xy = _mm_setzero_pd();
+        __m128d zw = _mm_setzero_pd();
+        for (int j = 0; j < size; j++) {
+            double const* src = control4 + 4 * (size_t)index[j];
+            __m128d w = _mm_set1_pd(weight[j]);
+            xy = _mm_add_pd(xy, _mm_mul_pd(_mm_loadu_pd(src), w));
+            zw = _mm_add_pd(zw, _mm_mul_pd(_mm_loadu_pd(src + 2), w));
+        }
+        _mm_storeu_pd(dst, xy);
+        _mm_store_sd(dst + 2, zw);
+#else
+        double x = 0.0, y = 0.0, z = 0.0;
+        for (int j = 0; j < size; j++) {
+            double const* src = control4 + 4 * (size_t)index[j];
+            x += weight[j] * src[0];
+            y += weight[j] * src[1];
+            z += weight[j] * src[2];
+        }
+        dst[0] = x;
+        dst[1] = y;
+        dst[2] = z;
+#endif
+    }
+}
+
+#ifdef SUBDIVIDER_AVX2_DISPATCH
+// AVX2 + FMA: two float control points per 8-wide fused multiply-add, one double control point per 4-wide one. 
+// Compiled for AVX2 whatever the build flags are, and only ever called if the CPU has it (see cpu_has_avx2). 
+__attribute__((target("avx2,fma")))
+static void gather_stencils_avx2(stencil_view const& stencils, float const* control4, float* dst3, int begin, int end) {
+    for (int i = begin; i < end; i++) {
+        int const* index = stencils.indices + stencils.offsets[i];
+        float const* weight = stencils.weights + stencils.offsets[i];
+        int size = stencils.sizes[i];
+        float* dst = dst3 + 3 * (size_t)i;
+        __m256 sum8 = _mm256_setzero_ps();
+        int j = 0;
+        for (; j + 1 < size; j += 2) {
+            __m256 src = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(control4 + 4 * (size_t)index[j])), 
+                                              _mm_loadu_ps(control4 + 4 * (size_t)index[j + 1]), 1);
+            __m256 w = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_set1_ps(weight[j])), _mm_set1_ps(weight[j + 1]), 1);
+            sum8 = _mm256_fmadd_ps(src, w, sum8);
+        }
+        __m128 sum = _mm_add_ps(_mm256_castps256_ps128(sum8), _mm256_extractf128_ps(sum8, 1));
+        if (j < size) {
+            sum = _mm_fmadd_ps(_mm_loadu_ps(control4 + 4 * (size_t)index[j]), _mm_set1_ps(weight[j]), sum);
+        }
+        _mm_storel_pi((__m64*)dst, sum);
+        _mm_store_ss(dst + 2, _mm_movehl_ps(sum, sum));
+    }
+}
+
+__attribute__((target("avx2,fma")))
+static void gather_stencils_avx2(stencil_view const& stencils, double const* control4, double* dst3, int begin, int end) {
+    for (int i = begin; i < end; i++) {
+        int const* index = stencils.indices + stencils.offsets[i];
+        float const* weight = stencils.weights + stencils.offsets[i];
+        int size = stencils.sizes[i];
+        double* dst = dst3 + 3 * (size_t)i;
+        __m256d sum = _mm256_setzero_pd();
+        for (int j = 0; j < size; j++) {
+            sum = _mm256_fmadd_pd(_mm256_loadu_pd(control4 + 4 * (size_t)index[j]), _mm256_set1_pd(weight[j]), sum);
+        }
+        _mm_storeu_pd(dst, _mm256_castpd256_pd128(sum));
+        _mm_store_sd(dst + 2, _mm256_extractf128_pd(sum, 1));
+    }
+}
+#endif
+
+static bool cpu_has_avx2() {
+#ifdef SUBDIVIDER_AVX2_DISPATCH
+    static const bool has_avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return has_avx2;
+#else
+    return false;
+#endif
+}
+
+// Process wide switch for the AVX2 kernels (subdivider_use_avx2), to check them against the baseline ones 
+static std::atomic<bool> avx2_allowed(true);
+
+static bool use_avx2() {
+    return avx2_allowed.load(std::memory_order_relaxed) && cpu_has_avx2();
+}
+
+// Picks the widest kernel the CPU runs. FMA rounds once instead of twice, 
+// so results can differ in the last bit between machines with and without AVX2. 
+template <typename Real>
+static void gather_stencils(stencil_view const& stencils, Real const* control4, Real* dst3, int begin, int end) {
+#ifdef SUBDIVIDER_AVX2_DISPATCH
+    if (use_avx2()) {
+        gather_stencils_avx2(stencils, control4, dst3, begin, end);
+        return;
+    }
+#endif
+    gather_stencils_baseline(stencils, control4, dst3, begin, end);
+}
+
+// Stencil i on its own, to evaluate it into a result slot other than i (see subdivider::update_vertices) 
+static stencil_view single_stencil(stencil_view const& stencils, int i) {
+    stencil_view one = stencils;
+    one.n_stencils = 1;
+    one.sizes += i;
+    one.offsets += i;
+    return one;
+}
+
+// Same, for interleaved primvars of any width (up to max_primvar_width floats per vertex). 
+// The first `split` floats of every result go to dst_a, the rest to dst_b, 
+// e.g. positions and extra channels out of one pass over an interleaved [x, y, z, channels...] buffer. 
+static const int max_primvar_width = 64;
+
+static void gather_stencils_interleaved(stencil_view const& stencils, float const* control, int width, int split, float* dst_a, float* dst_b, int begin, int end) {
+    float sum[max_primvar_width];
+    for (int i = begin; i < end; i++) {
+        int const* index = stencils.indices + stencils.offsets[i];
+        float const* weight = stencils.weights + stencils.offsets[i];
+        int size = stencils.sizes[i];
+        std::fill(sum, sum + width, 0.0f);
+        for (int j = 0; j < size; j++) {
+            float const* src = control + width * (size_t)index[j];
+            for (int k = 0; k < width; k++) {
+                sum[k] += weight[j] * src[k];
+            }
+        }
+        std::copy(sum, sum + split, dst_a + split * (size_t)i);
+        std::copy(sum + split, sum + width, dst_b + (width - split) * (size_t)i);
+    }
+}
+
+//---------------- Interleaved primvar buffer ----------------
+// Runtime-width counterpart of Vertex, for vertices carrying extra channels (and for face-varying values). 
+// PrimvarRefiner only needs operator[] on the buffer and Clear/AddWithWeight on what it returns, 
+// so the buffer hands out small references into one flat float array. 
+struct primvar_ref {
+    float* data;
+    int width;
+
+    void Clear(void* = 0) {
+        std::fill(data, data + width, 0.0f);
+    }
+
+    void AddWithWeight(primvar_ref const& src, float weight) {
+        for (int k = 0; k < width; k++) {
+            data[k] += weight * src.data[k];
+        }
+    }
+};
+
+struct primvar_buffer {
+    primvar_buffer(float* data, int width) : data(data), width(width) { }
+
+    primvar_ref operator[](int i) const {
+        primvar_ref ref = { data + width * (size_t)i, width };
+        return ref;
+    }
+
+    float* data;
+    int width;
+};
+
+// Last level destinations: positions only (interpolated from VertexT, 3 Reals per vertex), 
+// and positions + channels split into two arrays (interpolated from a primvar_buffer). 
+template <typename Real>
+struct position_ref_t {
+    Real* data;
+
+    void Clear(void* = 0) {
+        data[0] = data[1] = data[2] = Real(0);
+    }
+
+    template <typename V>
+    void AddWithWeight(V const& src, float weight) {
+        Real const* pos = src.GetPosition();
+        data[0] += weight * pos[0];
+        data[1] += weight * pos[1];
+        data[2] += weight * pos[2];
+    }
+};
+
+template <typename Real>
+struct position_buffer_t {
+    explicit position_buffer_t(Real* data) : data(data) { }
+
+    position_ref_t<Real> operator[](int i) const {
+        position_ref_t<Real> ref = { data + 3 * (size_t)i };
+        return ref;
+    }
+
+    Real* data;
+};
+
+typedef position_buffer_t<float> position_buffer;
+
+struct split_ref {
+    float* position;
+    float* channels;
+    int n_channels;
+
+    void Clear(void* = 0) {
+        position[0] = position[1] = position[2] = 0.0f;
+        std::fill(channels, channels + n_channels, 0.0f);
+    }
+
+    void AddWithWeight(primvar_ref const& src, float weight) {
+        for (int k = 0; k < 3; k++) {
+            position[k] += weight * src.data[k];
+        }
+        for (int k = 0; k < n_channels; k++) {
+            channels[k] += weight * src.data[3 + k];
+        }
+    }
+};
+
+struct split_buffer {
+    split_buffer(float* positions, float* channels, int n_channels) : positions(positions), channels(channels), n_channels(n_channels) { }
+
+    split_ref operator[](int i) const {
+        split_ref ref = { positions + 3 * (size_t)i, channels + n_channels * (size_t)i, n_channels };
+        return ref;
+    }
+
+    float* positions;
+    float* channels;
+    int n_channels;
+};
+
+//---------------- Thread pool ----------------
+// Persistent worker threads running parallel_for over task indices. 
+// Tasks are dealt out in contiguous blocks, one deque per thread; a thread pops from the front of its own deque 
+// and, once that is empty, steals from the back of the others. The calling thread works too. 
+// parallel_for is not reentrant: one pool serves one caller (i.e. one subdivider handle) at a time. 
+class task_pool {
+public:
+    explicit task_pool(int n_threads) : stop(false), generation(0), function(NULL), remaining(0) {
+        if (n_threads < 1) {
+            n_threads = 1;
+        }
+        for (int i = 0; i < n_threads; i++) {
+            queues.push_back(std::unique_ptr<task_queue>(new task_queue()));
+        }
+        for (int i = 1; i < n_threads; i++) {
+            workers.push_back(std::thread(&task_pool::worker_loop, this, i));
+        }
+    }
+
+    ~task_pool() {
+        {
+            std::lock_guard<std::mutex> lock(state_mutex);
+            stop = true;
+        }
+        wake.notify_all();
+        for (size_t i = 0; i < workers.size(); i++) {
+            workers[i].join();
+        }
+    }
+
+    int size() const {
+        return queues.size();
+    }
+
+    // Runs fn(i) for every i in [0, n), returns once all of them are done. 
+    void parallel_for(int n, std::function<void(int)> const& fn) {
+        if (n <= 0) {
+            return;
+        }
+        if (queues.size() == 1 || n == 1) {
+            for (int i = 0; i < n; i++) {
+                fn(i);
+            }
+            return;
+        }
+
+        // The function has to be in place before any task can be popped 
+        {
+            std::lock_guard<std::mutex> lock(state_mutex);
+            function = &fn;
+            remaining = n;
+            generation++;
+        }
+        int n_queues = queues.size();
+        for (int q = 0; q < n_queues; q++) {
+            std::lock_guard<std::mutex> lock(queues[q]->mutex);
+            for (int i = (int)((int64_t)n * q / n_queues); i < (int)((int64_t)n * (q + 1) / n_queues); i++) {
+                queues[q]->tasks.push_back(i);
+            }
+        }
+        wake.notify_all();
+
+        run_tasks(0);
+
+        std::unique_lock<std::mutex> lock(state_mutex);
+        done.wait(lock, [this] { return remaining == 0; });
+        function = NULL;
+    }
+
+private:
+    struct task_queue {
+        std::mutex mutex;
+        std::deque<int> tasks;
+    };
+
+    bool pop_task(int self, int& task) {
+        {
+            task_queue& own = *queues[self];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                task = own.tasks.front();
+                own.tasks.pop_front();
+                return true;
+            }
+        }
+        int n_queues = queues.size();
+        for (int k = 1; k < n_queues; k++) {
+            task_queue& victim = *queues[(self + k) % n_queues];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = victim.tasks.back();
+                victim.tasks.pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void run_tasks(int self) {
+        int task;
+        while (pop_task(self, task)) {
+            (*function)(task);
+            if (remaining.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(state_mutex);
+                done.notify_all();
+            }
+        }
+    }
+
+    void worker_loop(int self) {
+        unsigned int seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(state_mutex);
+                wake.wait(lock, [&] { return stop || generation != seen; });
+                if (stop) {
+                    return;
+                }
+                seen = generation;
+            }
+            run_tasks(self);
+        }
+    }
+
+    std::vector<std::unique_ptr<task_queue>> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex state_mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    bool stop;
+    unsigned int generation;
+    std::function<void(int)> const* function;
+    std::atomic<int> remaining;
+};
+
+static int hardware_threads() {
+    int n = std::thread::hardware_concurrency();
+    return n > 0 ? n : 1;
+}
+
+//---------------- Stats ----------------
+// Per-stage wall time (ms), element counts and bytes allocated, recorded by every refine call. 
+// Plain C struct, it goes through the C API as it is (see subdivider_stats). 
+// Building with -DSUBDIVIDER_NO_STATS compiles the recording out, the counters then stay at 0. 
+struct subdivider_stats {
+    int64_t calls;
+    int64_t cache_hits;
+    // Stages: descriptor + TopologyRefinerFactory::Create, RefineUniform, edge/face extraction, 
+    // stencil table creation, interpolation (level by level or stencils), copy-out to the caller, and the whole refine call 
+    double descriptor_ms;
+    double refine_ms;
+    double extract_ms;
+    double stencil_ms;
+    double interpolate_ms;
+    double copyout_ms;
+    double total_ms;
+    // Elements in and out 
+    int64_t verts_in;
+    int64_t faces_in;
+    int64_t verts_out;
+    int64_t edges_out;
+    int64_t faces_out;
+    // The engine's own allocations (result and scratch buffers, cached topology, stencil tables), 
+    // not counting OpenSubdiv's internal refiner tables 
+    int64_t bytes_allocated;
+    // Topologies loaded from the disk cache (see subdivider::set_disk_cache) 
+    int64_t disk_hits;
+};
+
+static void add_stats(subdivider_stats& sum, subdivider_stats const& stats) {
+    sum.calls += stats.calls;
+    sum.cache_hits += stats.cache_hits;
+    sum.descriptor_ms += stats.descriptor_ms;
+    sum.refine_ms += stats.refine_ms;
+    sum.extract_ms += stats.extract_ms;
+    sum.stencil_ms += stats.stencil_ms;
+    sum.interpolate_ms += stats.interpolate_ms;
+    sum.copyout_ms += stats.copyout_ms;
+    sum.total_ms += stats.total_ms;
+    sum.verts_in += stats.verts_in;
+    sum.faces_in += stats.faces_in;
+    sum.verts_out += stats.verts_out;
+    sum.edges_out += stats.edges_out;
+    sum.faces_out += stats.faces_out;
+    sum.bytes_allocated += stats.bytes_allocated;
+    sum.disk_hits += stats.disk_hits;
+}
+
+#ifndef SUBDIVIDER_NO_STATS
+// Adds the time until stop() (or the end of the scope) to a stats field 
+struct stage_timer {
+    explicit stage_timer(double& ms) : ms(&ms), start(std::chrono::steady_clock::now()) { }
+    ~stage_timer() { stop(); }
+
+    void stop() {
+        if (ms) {
+            *ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            ms = NULL;
+        }
+    }
+
+    double* ms;
+    std::chrono::steady_clock::time_point start;
+};
+#define SUBDIVIDER_TIMER(name, field) stage_timer name(stats_last.field)
+#define SUBDIVIDER_STOP(name) name.stop()
+#define SUBDIVIDER_STAT(statement) statement
+#else
+#define SUBDIVIDER_TIMER(name, field)
+#define SUBDIVIDER_STOP(name)
+#define SUBDIVIDER_STAT(statement)
+#endif
+
+template <typename T>
+static int64_t vector_bytes(std::vector<T> const& v) {
+    return (int64_t)v.capacity() * sizeof(T);
+}
+
+static int64_t stencil_bytes(Far::StencilTable const* table) {
+    if (table == NULL) {
+        return 0;
+    }
+    return vector_bytes(table->GetSizes()) + vector_bytes(table->GetOffsets()) 
+         + vector_bytes(table->GetControlIndices()) + vector_bytes(table->GetWeights());
+}
+
+//---------------- Mapped files ----------------
+// Used by the disk cache (subdivider::load_topology) and the executable's OBJ reader. 
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Read-only view of a whole file: memory mapped where there's mmap, read in one go otherwise. 
+class mapped_file {
+public:
+    explicit mapped_file(char const* path) : begin(NULL), end(NULL), mapping(NULL), length(0) {
+#ifndef _WIN32
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) {
+            return;
+        }
+        struct stat info;
+        if (fstat(fd, &info) == 0) {
+            length = info.st_size;
+            if (length == 0) {
+                begin = end = "";
+            } else {
+                void* data = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (data != MAP_FAILED) {
+                    madvise(data, length, MADV_SEQUENTIAL);
+                    mapping = data;
+                    begin = (char const*)data;
+                    end = begin + length;
+                }
+            }
+        }
+        close(fd);
+#else
+        FILE* file = fopen(path, "rb");
+        if (file == NULL) {
+            return;
+        }
+        fseek(file, 0, SEEK_END);
+        long size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        buffer.resize(size > 0 ? size : 0);
+        if (size <= 0 || fread(&buffer[0], 1, size, file) == (size_t)size) {
+            begin = buffer.empty() ? "" : &buffer[0];
+            end = begin + buffer.size();
+        }
+        fclose(file);
+#endif
+    }
+
+    ~mapped_file() {
+#ifndef _WIN32
+        if (mapping != NULL) {
+            munmap(mapping, length);
+        }
+#endif
+    }
+
+    bool ok() const {
+        return begin != NULL;
+    }
+
+    char const* begin;
+    char const* end;
+
+private:
+    mapped_file(mapped_file const&);
+    mapped_file& operator=(mapped_file const&);
+
+    void* mapping;
+    size_t length;
+    std::vector<char> buffer;
+};
+
+//---------------- Cache-friendly ordering ----------------
+// Face order for a post-transform vertex cache of cache_size vertices, Tipsify style (Sander, Nehab & Barczak 2007, 
+// for polygons): fan around the current vertex, then move on to the vertex among the ones just touched that is 
+// still in the cache and has faces left, or to a dead end (recently touched vertex with faces left), or the next such 
+// vertex by index. Linear time, and positions don't matter, so the order goes into the topology cache with everything else. 
+// Post-transform vertex cache size the orders are made for. GPUs have had 16 to 32 entries (or the equivalent) for a 
+// long time, and an order made for a larger cache than there is only loses a little. 
+static const int reorder_cache_size = 32;
+
+static void vertex_cache_order(int n_verts, std::vector<int> const& face_sizes, std::vector<int> const& faces, int cache_size, std::vector<int>& face_order) {
+    int n_faces = face_sizes.size();
+    std::vector<int> face_start(n_faces + 1, 0);
+    for (int f = 0; f < n_faces; f++) {
+        face_start[f + 1] = face_start[f] + face_sizes[f];
+    }
+    // Faces around every vertex (CSR), and how many of them are still to be emitted 
+    std::vector<int> live(n_verts, 0);
+    for (size_t k = 0; k < faces.size(); k++) {
+        live[faces[k]]++;
+    }
+    std::vector<int> adjacency_start(n_verts + 1, 0);
+    for (int v = 0; v < n_verts; v++) {
+        adjacency_start[v + 1] = adjacency_start[v] + live[v];
+    }
+    std::vector<int> adjacency(faces.size());
+    std::vector<int> fill(adjacency_start.begin(), adjacency_start.end() - 1);
+    for (int f = 0; f < n_faces; f++) {
+        for (int k = face_start[f]; k < face_start[f + 1]; k++) {
+            adjacency[fill[faces[k]]++] = f;
+        }
+    }
+
+    face_order.clear();
+    face_order.reserve(n_faces);
+    std::vector<char> emitted(n_faces, 0);
+    // Time every vertex last entered the cache, time advances by one per cache miss 
+    std::vector<int> stamp(n_verts, 0);
+    int time = cache_size + 1;
+    std::vector<int> dead_ends;
+    std::vector<int> candidates;
+    int cursor = 0;
+    int fanning = 0;
+    while (fanning >= 0 && fanning < n_verts) {
+        candidates.clear();
+        for (int a = adjacency_start[fanning]; a < adjacency_start[fanning + 1]; a++) {
+            int f = adjacency[a];
+            if (emitted[f]) {
+                continue;
+            }
+            emitted[f] = 1;
+            face_order.push_back(f);
+            for (int k = face_start[f]; k < face_start[f + 1]; k++) {
+                int v = faces[k];
+                dead_ends.push_back(v);
+                candidates.push_back(v);
+                live[v]--;
+                if (time - stamp[v] > cache_size) {
+                    stamp[v] = time++;
+                }
+            }
+        }
+        // Next fanning vertex: the oldest candidate that will still be cached after its own faces are out 
+        int next = -1;
+        int best = -1;
+        for (size_t c = 0; c < candidates.size(); c++) {
+            int v = candidates[c];
+            if (live[v] <= 0) {
+                continue;
+            }
+            int priority = 0;
+            if (time - stamp[v] + 2 * live[v] <= cache_size) {
+                priority = time - stamp[v];
+            }
+            if (priority > best) {
+                best = priority;
+                next = v;
+            }
+        }
+        while (next < 0 && !dead_ends.empty()) {
+            int v = dead_ends.back();
+            dead_ends.pop_back();
+            if (live[v] > 0) {
+                next = v;
+            }
+        }
+        while (next < 0 && cursor < n_verts) {
+            if (live[cursor] > 0) {
+                next = cursor;
+            }
+            cursor++;
+        }
+        fanning = next;
+    }
+}
+
+//---------------- Incoming mesh ----------------
+// Everything handed over by one refine call. 
+struct mesh_input {
+    mesh_input() : n_verts(0), n_faces(0), vertices(NULL), vertices_d(NULL), faceVerts(NULL), vertsPerFace(NULL), n_faceVerts(0), 
+        n_channels(0), channels(NULL), fvar_width(0), n_fvar_values(0), fvar_values(NULL), fvar_indices(NULL), face_levels(NULL), all_levels(false), reorder(false) { }
+
+    int n_verts;
+    int n_faces;
+    float (*vertices)[3];
+    // Double precision positions instead (refine_topology_d), vertices is NULL then 
+    double const* vertices_d;
+    int* faceVerts;
+    int* vertsPerFace;
+    // sum of vertsPerFace 
+    int n_faceVerts;
+
+    // Extra vertex channels (weights, colors, ...), n_channels floats per vertex, interleaved 
+    int n_channels;
+    float const* channels;
+
+    // One face-varying channel (e.g. UVs): n_fvar_values values of fvar_width floats, 
+    // indexed per face-vertex (fvar_indices is laid out like faceVerts). fvar_width == 0 means none. 
+    int fvar_width;
+    int n_fvar_values;
+    float const* fvar_values;
+    int* fvar_indices;
+
+    // Target level of every face for selective refinement (see subdivider::refine_selective), NULL refines uniformly
+    int const* face_levels;
+    // Keep every level rather than just the last one (see subdivider::refine_levels) 
+    bool all_levels;
+    // Cache-friendly order of the refined vertices and faces (see subdivider::set_reorder) 
+    bool reorder;
+
+    double position(int i, int k) const {
+        return vertices_d != NULL ? vertices_d[3 * (size_t)i + k] : vertices[i][k];
+    }
+
+    void count_faceVerts() {
+        n_faceVerts = 0;
+        for (int i = 0; i < n_faces; i++) {
+            n_faceVerts += vertsPerFace[i];
+        }
+    }
+};
+
+//---------------- Topology cache ----------------
+// Everything that only depends on the incoming faces (and the refinement settings), 
+// i.e. the refiner and the refined edges/faces. In a node tree the topology usually 
+// stays the same from frame to frame while only the positions move, 
+// so these are kept around and reused until the topology changes. 
+struct topology_entry {
+    topology_entry() : key(0), n_verts(0), maxlevel(0), scheme(0), vtx_boundary(0), fvar_linear(0), n_fvar_values(0), refiner(NULL), stencils(NULL), fvar_stencils(NULL), 
+        patches(NULL), patch_map(NULL), n_ptex_faces(0), nn_verts(0), nn_edges(0), nn_faces(0), nn_fvar_values(0), reordered(false) { }
+    ~topology_entry() { delete patch_map; delete patches; release_refinement(); }
+
+    // Bytes held by the entry's own arrays (see subdivider_stats::bytes_allocated) 
+    int64_t bytes() const {
+        return vector_bytes(faceVerts) + vector_bytes(vertsPerFace) + vector_bytes(fvar_indices_in) 
+             + vector_bytes(edges) + vector_bytes(face_sizes) + vector_bytes(faces) + vector_bytes(fvar_indices) 
+             + stencil_bytes(stencils) + stencil_bytes(fvar_stencils) 
+             + vector_bytes(inverse_offsets) + vector_bytes(inverse_stencils) 
+             + vector_bytes(face_levels) + vector_bytes(sub_verts) + vector_bytes(pick_offsets) 
+             + vector_bytes(pick_sources) + vector_bytes(pick_targets) 
+             + vector_bytes(level_verts) + vector_bytes(level_edges) + vector_bytes(level_faces) + vector_bytes(level_face_verts) 
+             + vector_bytes(vertex_order) + vector_bytes(vertex_rank) + vector_bytes(face_order);
+    }
+
+    // Drops the refined topology (and the stencils built from it) once the results are out, 
+    // leaving the extracted edges, faces and face-varying indices. Only for entries that aren't cached. 
+    void release_refinement() {
+        delete fvar_stencils;
+        delete stencils;
+        delete refiner;
+        fvar_stencils = NULL;
+        stencils = NULL;
+        refiner = NULL;
+        disk_stencils = stencil_view();
+        disk_fvar_stencils = stencil_view();
+        disk_file.reset();
+        std::vector<int>().swap(faceVerts);
+        std::vector<int>().swap(vertsPerFace);
+        std::vector<int>().swap(fvar_indices_in);
+        std::vector<int>().swap(face_levels);
+        std::vector<int>().swap(sub_verts);
+        std::vector<int>().swap(pick_offsets);
+        std::vector<int>().swap(pick_sources);
+        std::vector<int>().swap(pick_targets);
+    }
+
+    // Key
+    uint64_t key;
+    int n_verts;
+    int maxlevel;
+    // Sdc scheme and options it was refined with (see subdivider::stamp_scheme) 
+    int scheme;
+    int vtx_boundary;
+    int fvar_linear;
+    // Copies of the incoming topology, so a hash collision can never hand back the wrong mesh 
+    std::vector<int> faceVerts;
+    std::vector<int> vertsPerFace;
+    // Face-varying topology (empty without a face-varying channel)
+    int n_fvar_values;
+    std::vector<int> fvar_indices_in;
+
+    // Refined topology (NULL for maxlevel == 0). 
+    // Limit entries (maxlevel == limit_entry_level(isolation), see build_limit_topology) hold an adaptively refined one. 
+    Far::TopologyRefiner* refiner;
+    // Last level stencils, only built in stencil mode (NULL otherwise)
+    Far::StencilTable const* stencils;
+    Far::StencilTable const* fvar_stencils;
+
+    // Loaded from the disk cache instead: no refiner, the last level stencils point into the mapped file 
+    std::shared_ptr<mapped_file> disk_file;
+    stencil_view disk_stencils;
+    stencil_view disk_fvar_stencils;
+
+    // Limit surface (limit entries only): the patches, a map from (ptex face, u, v) to patch, 
+    // and `stencils` covers every refined vertex plus the patches' local points, so 
+    // [control vertices, stencils applied] is the buffer the patch vertex indices point into. 
+    Far::PatchTable const* patches;
+    Far::PatchMap const* patch_map;
+    int n_ptex_faces;
+
+    // Refined edges, flat (2 vertex indices each), and faces in CSR form: 
+    // face_sizes (vertices per face) plus the flat face-vertices in `faces`. 
+    // Uniformly refined faces are all quads (triangles with Loop), level 0 faces are the incoming ones. 
+    int nn_verts;
+    int nn_edges;
+    int nn_faces;
+    std::vector<int> edges;
+    std::vector<int> face_sizes;
+    std::vector<int> faces;
+    // Refined face-varying topology, one value index per face-vertex of `faces` 
+    int nn_fvar_values;
+    std::vector<int> fvar_indices;
+
+    // Inverse of the last level vertex stencils (CSR, built by the first update_vertices): 
+    // the refined vertices whose stencils use control vertex c are inverse_stencils[inverse_offsets[c], inverse_offsets[c+1]) 
+    std::vector<int> inverse_offsets;
+    std::vector<int> inverse_stencils;
+
+    // Selective refinement (see subdivider::refine_selective), empty otherwise: the incoming per-face levels (part of the key), 
+    // and `refiner` holds just the faces that get refined plus the ring of faces around them, as a mesh of its own, 
+    // with sub_verts[i] the control vertex of its vertex i. 
+    // Result vertex pick_targets[k] is vertex pick_sources[k] of level l for k in [pick_offsets[l], pick_offsets[l+1]) 
+    // (level 0 picks are control vertices, the others vertices of the refiner's levels). 
+    std::vector<int> face_levels;
+    std::vector<int> sub_verts;
+    std::vector<int> pick_offsets;
+    std::vector<int> pick_sources;
+    std::vector<int> pick_targets;
+
+    // Every level, 0 to maxlevel (see subdivider::refine_levels), empty otherwise: edges, face_sizes and faces hold them all 
+    // one after the other (with vertex indices local to their level), and level l starts at level_verts[l], level_edges[l], 
+    // level_faces[l] and level_face_verts[l] (maxlevel + 2 offsets each, the last ones are the totals). 
+    std::vector<int> level_verts;
+    std::vector<int> level_edges;
+    std::vector<int> level_faces;
+    std::vector<int> level_face_verts;
+
+    // Cache-friendly order (see subdivider::set_reorder), empty otherwise. edges, faces and fvar_indices are already 
+    // in it; result vertex i is vertex vertex_order[i] of the refiner (and of the stencils), vertex_rank is the inverse, 
+    // and result face i is the refiner's face face_order[i]. 
+    // reordered is part of what the entry was refined for (level 0 entries stay in the caller's order regardless). 
+    bool reordered;
+    std::vector<int> vertex_order;
+    std::vector<int> vertex_rank;
+    std::vector<int> face_order;
+
+private:
+    topology_entry(topology_entry const&);
+    topology_entry& operator=(topology_entry const&);
+};
+
+//---------------- Disk cache format ----------------
+// One file per refined topology (<key>.osdtopo in the cache directory, see subdivider::set_disk_cache): 
+// a header, then the arrays exactly as they are in memory (native byte order, each starting on 8 bytes), 
+// so loading one is a mmap plus validation, and the stencils are applied straight from the mapping. 
+// Every element is 4 bytes (int or float). Any change to the layout bumps disk_format_version. 
+static const uint32_t disk_format_version = 1;
+static const uint32_t disk_byte_order = 0x01020304;
+
+enum disk_section {
+    disk_faceVerts, disk_vertsPerFace, disk_fvar_indices_in, 
+    disk_edges, disk_face_sizes, disk_faces, disk_fvar_indices, 
+    disk_stencil_sizes, disk_stencil_offsets, disk_stencil_indices, disk_stencil_weights, 
+    disk_fvar_stencil_sizes, disk_fvar_stencil_offsets, disk_fvar_stencil_indices, disk_fvar_stencil_weights, 
+    disk_n_sections
+};
+
+struct disk_header {
+    char magic[8];
+    uint32_t format_version;
+    uint32_t byte_order;
+    // OPENSUBDIV_VERSION_STRING of the build that wrote it 
+    char osd_version[32];
+    uint64_t key;
+    // What the topology was refined for, see subdivider::disk_settings 
+    int32_t settings[8];
+    int32_t nn_verts;
+    int32_t nn_edges;
+    int32_t nn_faces;
+    int32_t nn_fvar_values;
+    int32_t n_stencils;
+    int32_t n_fvar_stencils;
+    // Byte offset (from the start of the file) and element count of every section 
+    uint64_t offset[disk_n_sections];
+    uint64_t count[disk_n_sections];
+    // Of everything after the header 
+    uint64_t checksum;
+};
+
+static const char disk_magic[8] = { 'O', 'S', 'D', 'T', 'O', 'P', 'O', 0 };
+
+// FNV-1a over 8 byte words, continuing from hash. A partial last word is padded with zeros, 
+// like the sections are in the file, so hashing the sections one by one or the whole payload at once agree. 
+static const uint64_t disk_checksum_start = 14695981039346656037ULL;
+
+static uint64_t disk_checksum(uint64_t hash, char const* data, size_t size) {
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        memcpy(&word, data + i, 8);
+        hash = (hash ^ word) * 1099511628211ULL;
+    }
+    if (i < size) {
+        uint64_t word = 0;
+        memcpy(&word, data + i, size - i);
+        hash = (hash ^ word) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+static size_t disk_padded(size_t bytes) {
+    return (bytes + 7) & ~(size_t)7;
+}
+
+//---------------- Async jobs ----------------
+// One subdivider::submit call: a copy of its input (the caller's buffers may be gone by the time it runs),
+// the settings at the time of the call, and the results once it's done (see subdivider::collect).
+enum job_status {
+    job_unknown = -1, // never submitted, or already collected / released
+    job_pending = 0,
+    job_running = 1,
+    job_done = 2,
+    job_cancelled = 3,
+    job_failed = 4
+};
+
+struct refine_job {
+    int64_t ticket = 0;
+    // Guarded by the owner's job_mutex
+    int status = job_pending;
+    // Checked by the worker between refinement levels and interpolation chunks
+    std::atomic<bool> cancel{false};
+
+    // -------- Input --------
+    int n_verts = 0;
+    int n_faces = 0;
+    std::vector<float> vertices;
+    std::vector<int> faceVerts;
+    std::vector<int> vertsPerFace;
+
+    int maxlevel = 0;
+    int scheme = 0;
+    int threads = 0;
+    int cache_size = 0;
+    int use_stencils = false;
+    int use_double = false;
+    int reorder = false;
+    std::string disk_cache_dir;
+
+    // -------- Results --------
+    std::shared_ptr<topology_entry> entry;
+    int nn_verts = 0;
+    int nn_edges = 0;
+    int nn_faces = 0;
+    int nn_face_verts = 0;
+    int cache_hit = false;
+    int disk_hit = false;
+    std::vector<float> new_vertices;
+    std::vector<double> new_vertices_d;
+    subdivider_stats stats = subdivider_stats();
+};
+
+class subdivider {
+private:
+    void reset() {
+        // Need to do this otherwise these values end up growing as you do subdivisions on top of each other
+        new_vertices.clear();
+        new_vertices_d.clear();
+        new_channels.clear();
+        new_fvar_values.clear();
+        n_channels = 0;
+        fvar_width = 0;
+        nn_fvar_values = 0;
+        updatable = false;
+    }
+
+    // ---------------- Scheme ----------------
+    Sdc::SchemeType scheme_type() const {
+        return (Sdc::SchemeType)scheme;
+    }
+
+    Sdc::Options scheme_options() const {
+        Sdc::Options options;
+        options.SetVtxBoundaryInterpolation(Sdc::Options::VTX_BOUNDARY_EDGE_ONLY);
+        // Face-varying data (UVs) keeps its corners, like Blender's default UV smoothing 
+        options.SetFVarLinearInterpolation(Sdc::Options::FVAR_LINEAR_CORNERS_ONLY);
+        return options;
+    }
+
+    // ---------------- Topology cache ----------------
+    // FNV-1a, over the topology arrays and everything else that changes the refined topology. 
+    static uint64_t hash_ints(uint64_t hash, int const* values, int n) {
+        unsigned char const* bytes = reinterpret_cast<unsigned char const*>(values);
+        for (size_t i = 0; i < n * sizeof(int); i++) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    // Face-varying values only count when there is a face-varying channel 
+    static int fvar_count(mesh_input const& mesh) {
+        return mesh.fvar_width > 0 ? mesh.n_fvar_values : 0;
+    }
+
+    uint64_t topology_key(mesh_input const& mesh, int level) const {
+        Sdc::Options options = scheme_options();
+        int header[7] = { mesh.n_verts, mesh.n_faces, level, (int)scheme_type(), 
+            (int)options.GetVtxBoundaryInterpolation(), (int)options.GetFVarLinearInterpolation(), fvar_count(mesh) };
+        uint64_t hash = 14695981039346656037ULL;
+        hash = hash_ints(hash, header, 7);
+        hash = hash_ints(hash, mesh.vertsPerFace, mesh.n_faces);
+        hash = hash_ints(hash, mesh.faceVerts, mesh.n_faceVerts);
+        if (fvar_count(mesh) > 0) {
+            hash = hash_ints(hash, mesh.fvar_indices, mesh.n_faceVerts);
+        }
+        if (mesh.face_levels != NULL) {
+            hash = hash_ints(hash, mesh.face_levels, mesh.n_faces);
+        }
+        if (mesh.all_levels) {
+            int all_levels = 1;
+            hash = hash_ints(hash, &all_levels, 1);
+        }
+        if (mesh.reorder) {
+            int reorder = 2;
+            hash = hash_ints(hash, &reorder, 1);
+        }
+        return hash;
+    }
+
+    // The scheme is part of the key too, and set_scheme leaves the cache alone, so it's compared like the topology 
+    void stamp_scheme(topology_entry& entry) const {
+        Sdc::Options options = scheme_options();
+        entry.scheme = (int)scheme_type();
+        entry.vtx_boundary = (int)options.GetVtxBoundaryInterpolation();
+        entry.fvar_linear = (int)options.GetFVarLinearInterpolation();
+    }
+
+    bool same_topology(topology_entry const& entry, mesh_input const& mesh) const {
+        Sdc::Options options = scheme_options();
+        return entry.n_verts == mesh.n_verts
+            && entry.scheme == (int)scheme_type()
+            && entry.vtx_boundary == (int)options.GetVtxBoundaryInterpolation()
+            && entry.fvar_linear == (int)options.GetFVarLinearInterpolation()
+            && (int)entry.vertsPerFace.size() == mesh.n_faces
+            && (int)entry.faceVerts.size() == mesh.n_faceVerts
+            && entry.n_fvar_values == fvar_count(mesh)
+            && std::equal(entry.vertsPerFace.begin(), entry.vertsPerFace.end(), mesh.vertsPerFace)
+            && std::equal(entry.faceVerts.begin(), entry.faceVerts.end(), mesh.faceVerts)
+            && (entry.n_fvar_values == 0 || std::equal(entry.fvar_indices_in.begin(), entry.fvar_indices_in.end(), mesh.fvar_indices))
+            && (entry.face_levels.empty() == (mesh.face_levels == NULL || mesh.n_faces == 0))
+            && std::equal(entry.face_levels.begin(), entry.face_levels.end(), mesh.face_levels)
+            && entry.level_verts.empty() == !mesh.all_levels 
+            && entry.reordered == mesh.reorder;
+    }
+
+    // Most recently used entries first 
+    std::list<std::shared_ptr<topology_entry>> topology_cache;
+
+    std::list<std::shared_ptr<topology_entry>>::iterator find_topology(uint64_t key, mesh_input const& mesh, int level) {
+        std::list<std::shared_ptr<topology_entry>>::iterator it = topology_cache.begin();
+        for (; it != topology_cache.end(); ++it) {
+            topology_entry const& entry = **it;
+            if (entry.key == key && entry.maxlevel == level && same_topology(entry, mesh)) {
+                break;
+            }
+        }
+        return it;
+    }
+
+    void trim_cache() {
+        while ((int)topology_cache.size() > cache_size) {
+            topology_cache.pop_back();
+        }
+    }
+
+    // ---------------- Build topology (cache miss) ----------------
+    // Unrefined Far::TopologyRefiner of the incoming mesh (with its face-varying channel, if any) 
+    Far::TopologyRefiner* create_refiner(mesh_input const& mesh) const {
+        typedef Far::TopologyDescriptor Descriptor;
+        Descriptor desc;
+
+        desc.numVertices = mesh.n_verts;
+        desc.numFaces = mesh.n_faces;
+        desc.vertIndicesPerFace = mesh.faceVerts;
+        desc.numVertsPerFace = mesh.vertsPerFace;
+
+        Descriptor::FVarChannel fvar_channel;
+        if (fvar_count(mesh) > 0) {
+            fvar_channel.numValues = mesh.n_fvar_values;
+            fvar_channel.valueIndices = mesh.fvar_indices;
+            desc.numFVarChannels = 1;
+            desc.fvarChannels = &fvar_channel;
+        }
+
+        // -------- Configure Refiner --------
+        Sdc::SchemeType type = scheme_type();
+        Sdc::Options options = scheme_options();
+
+        // Instantiate a Far::TopologyRefiner from the descriptor (and refinement options) 
+        return Far::TopologyRefinerFactory<Descriptor>::Create(desc, Far::TopologyRefinerFactory<Descriptor>::Options(type, options));
+    }
+
+    std::shared_ptr<topology_entry> build_topology(uint64_t key, mesh_input const& mesh) {
+        std::shared_ptr<topology_entry> entry = std::make_shared<topology_entry>();
+        entry->key = key;
+        stamp_scheme(*entry);
+        entry->n_verts = mesh.n_verts;
+        entry->maxlevel = maxlevel;
+        entry->faceVerts.assign(mesh.faceVerts, mesh.faceVerts + mesh.n_faceVerts);
+        entry->vertsPerFace.assign(mesh.vertsPerFace, mesh.vertsPerFace + mesh.n_faces);
+        entry->n_fvar_values = fvar_count(mesh);
+        if (entry->n_fvar_values > 0) {
+            entry->fvar_indices_in.assign(mesh.fvar_indices, mesh.fvar_indices + mesh.n_faceVerts);
+        }
+
+        if (maxlevel == 0) {
+            SUBDIVIDER_TIMER(extract_timer, extract_ms);
+            edges_only(mesh.n_verts, mesh.n_faces, mesh.faceVerts, mesh.vertsPerFace, entry->edges);
+            entry->nn_verts = mesh.n_verts;
+            entry->nn_edges = entry->edges.size() / 2;
+            entry->nn_faces = mesh.n_faces;
+            entry->face_sizes = entry->vertsPerFace;
+            entry->faces = entry->faceVerts;
+            entry->nn_fvar_values = entry->n_fvar_values;
+            entry->fvar_indices = entry->fvar_indices_in;
+            return entry;
+        }
+
+        SUBDIVIDER_TIMER(descriptor_timer, descriptor_ms);
+        Far::TopologyRefiner* refiner = create_refiner(mesh);
+        SUBDIVIDER_STOP(descriptor_timer);
+        if (refiner == NULL) {
+            // Topology the scheme can't take (e.g. non-triangles with Loop), OpenSubdiv has already said why. 
+            // The entry stays empty and so do the results. 
+            return entry;
+        }
+
+        // Uniformly refine the topology up to "maxlevel" 
+        // (by default the last level only gets face-vertices, the edges have to be asked for)
+        Far::TopologyRefiner::UniformOptions refine_options(maxlevel);
+        refine_options.fullTopologyInLastLevel = true;
+        SUBDIVIDER_TIMER(refine_timer, refine_ms);
+        refiner->RefineUniform(refine_options);
+        SUBDIVIDER_STOP(refine_timer);
+        entry->refiner = refiner;
+
+        // ---- New Edges and Faces ----
+        SUBDIVIDER_TIMER(extract_timer, extract_ms);
+        // This renames refiner->GetLevel(maxlevel) basically (to refLastLevel)
+        Far::TopologyLevel const& refLastLevel = refiner->GetLevel(maxlevel); // refLastLevel = address of refiner->GetLevel(maxlevel)
+        entry->nn_verts = refLastLevel.GetNumVertices();
+
+        // The refined level already has unique edges, no need to rebuild them from the faces 
+        entry->nn_edges = refLastLevel.GetNumEdges();
+        entry->edges.resize(2 * (size_t)entry->nn_edges);
+        for (int i = 0; i < entry->nn_edges; i++) {
+            Far::ConstIndexArray everts = refLastLevel.GetEdgeVertices(i);
+            entry->edges[2 * i] = everts[0];
+            entry->edges[2 * i + 1] = everts[1];
+        }
+
+        // Faces come out as CSR whatever their size (quads for CatMark and Bilinear, triangles for Loop) 
+        entry->nn_faces = refLastLevel.GetNumFaces();
+        entry->face_sizes.resize(entry->nn_faces);
+        entry->faces.reserve(4 * (size_t)entry->nn_faces);
+
+        for (int i = 0; i < entry->nn_faces; i++) {
+            Far::ConstIndexArray fverts = refLastLevel.GetFaceVertices(i);
+            entry->face_sizes[i] = fverts.size();
+            entry->faces.insert(entry->faces.end(), fverts.begin(), fverts.end());
+        }
+
+        if (entry->n_fvar_values > 0) {
+            entry->nn_fvar_values = refLastLevel.GetNumFVarValues(0);
+            entry->fvar_indices.reserve(entry->faces.size());
+            for (int i = 0; i < entry->nn_faces; i++) {
+                Far::ConstIndexArray fvalues = refLastLevel.GetFaceFVarValues(i, 0);
+                entry->fvar_indices.insert(entry->fvar_indices.end(), fvalues.begin(), fvalues.end());
+            }
+        }
+
+        return entry;
+    }
+
+    // ---------------- Selective refinement (cache miss) ----------------
+    // Every face goes to its own level (mesh.face_levels, clamped to [0, maxlevel]) and the result is one watertight mesh:
+    // where a coarser face borders finer ones, the vertices the finer side adds along the shared edges are inserted
+    // into the coarser face (which turns into an n-gon), so there are no T-junctions to crack open.
+    // A face's refined surface only depends on the faces sharing a vertex with it, so only the refined faces and that ring
+    // around them go through Far, as a mesh of their own, refined uniformly up to the highest level asked for.
+    // A vertex shared by faces of different levels takes its position at the finest of them.
+    std::shared_ptr<topology_entry> build_selective_topology(uint64_t key, mesh_input const& mesh) {
+        std::shared_ptr<topology_entry> entry = std::make_shared<topology_entry>();
+        entry->key = key;
+        stamp_scheme(*entry);
+        entry->n_verts = mesh.n_verts;
+        entry->maxlevel = maxlevel;
+        entry->faceVerts.assign(mesh.faceVerts, mesh.faceVerts + mesh.n_faceVerts);
+        entry->vertsPerFace.assign(mesh.vertsPerFace, mesh.vertsPerFace + mesh.n_faces);
+        entry->face_levels.assign(mesh.face_levels, mesh.face_levels + mesh.n_faces);
+
+        int n_verts = mesh.n_verts;
+        int n_faces = mesh.n_faces;
+        std::vector<int> face_start(n_faces + 1, 0);
+        std::vector<int> levels(n_faces);
+        int top = 0;
+        for (int f = 0; f < n_faces; f++) {
+            face_start[f + 1] = face_start[f] + mesh.vertsPerFace[f];
+            levels[f] = std::max(0, std::min(mesh.face_levels[f], maxlevel));
+            top = std::max(top, levels[f]);
+        }
+
+        // -------- Sub mesh: the refined faces plus the ring around them --------
+        SUBDIVIDER_TIMER(descriptor_timer, descriptor_ms);
+        std::vector<char> near_refined(n_verts, 0);
+        for (int f = 0; f < n_faces; f++) {
+            for (int j = face_start[f]; j < face_start[f + 1] && levels[f] > 0; j++) {
+                near_refined[mesh.faceVerts[j]] = 1;
+            }
+        }
+        std::vector<int> sub_index(n_verts, -1);
+        std::vector<int> sub_face(n_faces, -1);
+        std::vector<int> sub_roots;
+        std::vector<int> sub_faceVerts;
+        std::vector<int> sub_vertsPerFace;
+        for (int f = 0; f < n_faces; f++) {
+            bool refined_nearby = false;
+            for (int j = face_start[f]; j < face_start[f + 1]; j++) {
+                refined_nearby = refined_nearby || near_refined[mesh.faceVerts[j]];
+            }
+            if (!refined_nearby) {
+                continue;
+            }
+            sub_face[f] = sub_roots.size();
+            sub_roots.push_back(f);
+            sub_vertsPerFace.push_back(mesh.vertsPerFace[f]);
+            for (int j = face_start[f]; j < face_start[f + 1]; j++) {
+                int v = mesh.faceVerts[j];
+                if (sub_index[v] < 0) {
+                    sub_index[v] = entry->sub_verts.size();
+                    entry->sub_verts.push_back(v);
+                }
+                sub_faceVerts.push_back(sub_index[v]);
+            }
+        }
+        SUBDIVIDER_STOP(descriptor_timer);
+
+        Far::TopologyRefiner* refiner = NULL;
+        if (top > 0) {
+            mesh_input sub;
+            sub.n_verts = entry->sub_verts.size();
+            sub.n_faces = sub_roots.size();
+            sub.faceVerts = &sub_faceVerts[0];
+            sub.vertsPerFace = &sub_vertsPerFace[0];
+            sub.count_faceVerts();
+            SUBDIVIDER_TIMER(create_timer, descriptor_ms);
+            refiner = create_refiner(sub);
+            SUBDIVIDER_STOP(create_timer);
+            if (refiner == NULL) {
+                return entry;
+            }
+            SUBDIVIDER_TIMER(refine_timer, refine_ms);
+            refiner->RefineUniform(Far::TopologyRefiner::UniformOptions(top));
+            entry->refiner = refiner;
+        }
+
+        // -------- Vertex identity across levels --------
+        // A vertex and its child vertex on the next level are the same result vertex. Ids below n_verts are the control vertices,
+        // the vertices every level adds (in faces and on edges) are numbered after them.
+        SUBDIVIDER_TIMER(extract_timer, extract_ms);
+        std::vector<std::vector<int> > ids(top + 1);
+        // Incoming face every refined face comes from
+        std::vector<std::vector<int> > roots(top + 1);
+        int n_ids = n_verts;
+        if (top > 0) {
+            ids[0] = entry->sub_verts;
+            roots[0] = sub_roots;
+        }
+        for (int l = 1; l <= top; l++) {
+            Far::TopologyLevel const& parent = refiner->GetLevel(l - 1);
+            Far::TopologyLevel const& child = refiner->GetLevel(l);
+            ids[l].assign(child.GetNumVertices(), -1);
+            for (int v = 0; v < parent.GetNumVertices(); v++) {
+                Far::Index c = parent.GetVertexChildVertex(v);
+                if (Far::IndexIsValid(c)) {
+                    ids[l][c] = ids[l - 1][v];
+                }
+            }
+            for (int v = 0; v < child.GetNumVertices(); v++) {
+                if (ids[l][v] < 0) {
+                    ids[l][v] = n_ids++;
+                }
+            }
+            roots[l].resize(child.GetNumFaces());
+            for (int f = 0; f < parent.GetNumFaces(); f++) {
+                Far::ConstIndexArray children = parent.GetFaceChildFaces(f);
+                for (int c = 0; c < children.size(); c++) {
+                    roots[l][children[c]] = roots[l - 1][f];
+                }
+            }
+        }
+
+        // -------- The finest level every vertex is used at --------
+        std::vector<int> used_level(n_ids, -1);
+        for (int f = 0; f < n_faces; f++) {
+            for (int j = face_start[f]; j < face_start[f + 1] && levels[f] == 0; j++) {
+                used_level[mesh.faceVerts[j]] = 0;
+            }
+        }
+        for (int l = 1; l <= top; l++) {
+            Far::TopologyLevel const& level = refiner->GetLevel(l);
+            for (int f = 0; f < level.GetNumFaces(); f++) {
+                if (levels[roots[l][f]] != l) {
+                    continue;
+                }
+                Far::ConstIndexArray fverts = level.GetFaceVertices(f);
+                for (int j = 0; j < fverts.size(); j++) {
+                    used_level[ids[l][fverts[j]]] = l;
+                }
+            }
+        }
+
+        // -------- Faces, each at its own level --------
+        std::vector<int>& face_sizes = entry->face_sizes;
+        std::vector<int>& faces = entry->faces;
+        for (int f = 0; f < n_faces; f++) {
+            if (levels[f] != 0) {
+                continue;
+            }
+            size_t start = faces.size();
+            if (sub_face[f] < 0) {
+                // Nothing refined around it
+                faces.insert(faces.end(), mesh.faceVerts + face_start[f], mesh.faceVerts + face_start[f + 1]);
+            } else {
+                selective_face(*refiner, ids, used_level, 0, sub_face[f], faces);
+            }
+            face_sizes.push_back(faces.size() - start);
+        }
+        for (int l = 1; l <= top; l++) {
+            Far::TopologyLevel const& level = refiner->GetLevel(l);
+            for (int f = 0; f < level.GetNumFaces(); f++) {
+                if (levels[roots[l][f]] == l) {
+                    size_t start = faces.size();
+                    selective_face(*refiner, ids, used_level, l, f, faces);
+                    face_sizes.push_back(faces.size() - start);
+                }
+            }
+        }
+
+        // -------- Number the used vertices, and where each one is picked from --------
+        std::vector<int> result_index(n_ids, -1);
+        int nn_verts = 0;
+        for (int c = 0; c < n_ids; c++) {
+            if (used_level[c] >= 0) {
+                result_index[c] = nn_verts++;
+            }
+        }
+        for (size_t k = 0; k < faces.size(); k++) {
+            faces[k] = result_index[faces[k]];
+        }
+        entry->pick_offsets.assign(1, 0);
+        for (int c = 0; c < n_verts; c++) {
+            if (used_level[c] == 0) {
+                entry->pick_sources.push_back(c);
+                entry->pick_targets.push_back(result_index[c]);
+            }
+        }
+        entry->pick_offsets.push_back(entry->pick_sources.size());
+        for (int l = 1; l <= top; l++) {
+            for (int v = 0; v < (int)ids[l].size(); v++) {
+                if (used_level[ids[l][v]] == l) {
+                    entry->pick_sources.push_back(v);
+                    entry->pick_targets.push_back(result_index[ids[l][v]]);
+                }
+            }
+            entry->pick_offsets.push_back(entry->pick_sources.size());
+        }
+
+        entry->nn_verts = nn_verts;
+        entry->nn_faces = face_sizes.size();
+        edges_only(nn_verts, entry->nn_faces, faces.data(), face_sizes.data(), entry->edges);
+        entry->nn_edges = entry->edges.size() / 2;
+        return entry;
+    }
+
+    // Appends face f of level l (as vertex ids), with the vertices finer neighbours add along its edges
+    static void selective_face(Far::TopologyRefiner const& refiner, std::vector<std::vector<int> > const& ids,
+                               std::vector<int> const& used_level, int l, int f, std::vector<int>& face) {
+        Far::TopologyLevel const& level = refiner.GetLevel(l);
+        Far::ConstIndexArray fverts = level.GetFaceVertices(f);
+        Far::ConstIndexArray fedges = level.GetFaceEdges(f);
+        for (int j = 0; j < fverts.size(); j++) {
+            face.push_back(ids[l][fverts[j]]);
+            // Face edge j runs from face vertex j to j + 1
+            selective_edge(refiner, ids, used_level, l, fedges[j], fverts[j], face);
+        }
+    }
+
+    // Vertices used by finer faces along edge e of level l, in order from its vertex `from`
+    static void selective_edge(Far::TopologyRefiner const& refiner, std::vector<std::vector<int> > const& ids,
+                               std::vector<int> const& used_level, int l, Far::Index e, Far::Index from, std::vector<int>& face) {
+        if (l + 1 >= refiner.GetNumLevels()) {
+            return;
+        }
+        Far::TopologyLevel const& level = refiner.GetLevel(l);
+        Far::Index middle = level.GetEdgeChildVertex(e);
+        if (!Far::IndexIsValid(middle) || used_level[ids[l + 1][middle]] < 0) {
+            return;
+        }
+        // Child edge i is the half at edge vertex i
+        Far::ConstIndexArray halves = level.GetEdgeChildEdges(e);
+        int first = level.GetEdgeVertices(e)[0] == from ? 0 : 1;
+        selective_edge(refiner, ids, used_level, l + 1, halves[first], level.GetVertexChildVertex(from), face);
+        face.push_back(ids[l + 1][middle]);
+        selective_edge(refiner, ids, used_level, l + 1, halves[1 - first], middle, face);
+    }
+
+    // ---------------- Every level (cache miss) ----------------
+    // Like build_topology, but the edges and faces of every level from 0 to maxlevel are kept, one level after the other. 
+    std::shared_ptr<topology_entry> build_levels_topology(uint64_t key, mesh_input const& mesh) {
+        std::shared_ptr<topology_entry> entry = std::make_shared<topology_entry>();
+        entry->key = key;
+        stamp_scheme(*entry);
+        entry->n_verts = mesh.n_verts;
+        entry->maxlevel = maxlevel;
+        entry->faceVerts.assign(mesh.faceVerts, mesh.faceVerts + mesh.n_faceVerts);
+        entry->vertsPerFace.assign(mesh.vertsPerFace, mesh.vertsPerFace + mesh.n_faces);
+
+        SUBDIVIDER_TIMER(descriptor_timer, descriptor_ms);
+        Far::TopologyRefiner* refiner = create_refiner(mesh);
+        SUBDIVIDER_STOP(descriptor_timer);
+        if (refiner == NULL) {
+            return entry;
+        }
+        if (maxlevel > 0) {
+            Far::TopologyRefiner::UniformOptions refine_options(maxlevel);
+            refine_options.fullTopologyInLastLevel = true;
+            SUBDIVIDER_TIMER(refine_timer, refine_ms);
+            refiner->RefineUniform(refine_options);
+        }
+        entry->refiner = refiner;
+
+        SUBDIVIDER_TIMER(extract_timer, extract_ms);
+        int total_faces = 0;
+        for (int l = 0; l <= maxlevel; l++) {
+            total_faces += refiner->GetLevel(l).GetNumFaces();
+        }
+        entry->face_sizes.reserve(total_faces);
+        entry->level_verts.assign(1, 0);
+        entry->level_edges.assign(1, 0);
+        entry->level_faces.assign(1, 0);
+        entry->level_face_verts.assign(1, 0);
+        for (int l = 0; l <= maxlevel; l++) {
+            Far::TopologyLevel const& level = refiner->GetLevel(l);
+            for (int i = 0; i < level.GetNumEdges(); i++) {
+                Far::ConstIndexArray everts = level.GetEdgeVertices(i);
+                entry->edges.push_back(everts[0]);
+                entry->edges.push_back(everts[1]);
+            }
+            for (int i = 0; i < level.GetNumFaces(); i++) {
+                Far::ConstIndexArray fverts = level.GetFaceVertices(i);
+                entry->face_sizes.push_back(fverts.size());
+                entry->faces.insert(entry->faces.end(), fverts.begin(), fverts.end());
+            }
+            entry->level_verts.push_back(entry->level_verts.back() + level.GetNumVertices());
+            entry->level_edges.push_back(entry->edges.size() / 2);
+            entry->level_faces.push_back(entry->face_sizes.size());
+            entry->level_face_verts.push_back(entry->faces.size());
+        }
+        entry->nn_verts = entry->level_verts.back();
+        entry->nn_edges = entry->level_edges.back();
+        entry->nn_faces = entry->level_faces.back();
+        return entry;
+    }
+
+    // The cached topology of mesh at maxlevel, or a new one from build(key, mesh), becomes `current`. 
+    // For the kinds of refinement the disk cache doesn't take (refine_selective, refine_levels). 
+    template <typename Build>
+    void use_topology(mesh_input const& mesh, Build build) {
+        uint64_t key = topology_key(mesh, maxlevel);
+        std::list<std::shared_ptr<topology_entry>>::iterator it = find_topology(key, mesh, maxlevel);
+        cache_hit = it != topology_cache.end();
+        disk_hit = false;
+        if (cache_hit) {
+            topology_cache.splice(topology_cache.begin(), topology_cache, it);
+            current = topology_cache.front();
+        } else {
+            current = build(key, mesh);
+            if (cache_size > 0) {
+                topology_cache.push_front(current);
+                trim_cache();
+            }
+        }
+    }
+
+    // ---------------- Cache-friendly order ----------------
+    // Puts a uniform topology fresh from build_topology or the disk cache (which keeps OpenSubdiv's order) into 
+    // vertex cache order: faces (and their face-varying indices) in vertex_cache_order, vertices numbered by first use 
+    // along them, edges sorted by their lower vertex. The refiner and the stencils keep their own numbering. 
+    void reorder_topology(topology_entry& entry) {
+        entry.reordered = true;
+        if (entry.maxlevel <= 0 || entry.nn_verts <= 0) {
+            return;
+        }
+        SUBDIVIDER_TIMER(reorder_timer, extract_ms);
+        vertex_cache_order(entry.nn_verts, entry.face_sizes, entry.faces, reorder_cache_size, entry.face_order);
+        std::vector<int> face_start(entry.nn_faces + 1, 0);
+        for (int f = 0; f < entry.nn_faces; f++) {
+            face_start[f + 1] = face_start[f] + entry.face_sizes[f];
+        }
+
+        // -------- Vertices, by first use --------
+        std::vector<int>& rank = entry.vertex_rank;
+        std::vector<int>& order = entry.vertex_order;
+        rank.assign(entry.nn_verts, -1);
+        order.clear();
+        order.reserve(entry.nn_verts);
+        for (size_t k = 0; k < entry.face_order.size(); k++) {
+            int f = entry.face_order[k];
+            for (int j = face_start[f]; j < face_start[f + 1]; j++) {
+                int v = entry.faces[j];
+                if (rank[v] < 0) {
+                    rank[v] = order.size();
+                    order.push_back(v);
+                }
+            }
+        }
+        // Vertices on no face (unused control vertices carried along) go last 
+        for (int v = 0; v < entry.nn_verts; v++) {
+            if (rank[v] < 0) {
+                rank[v] = order.size();
+                order.push_back(v);
+            }
+        }
+
+        // -------- Faces --------
+        bool fvar = !entry.fvar_indices.empty();
+        std::vector<int> face_sizes, faces, fvar_indices;
+        face_sizes.reserve(entry.face_sizes.size());
+        faces.reserve(entry.faces.size());
+        fvar_indices.reserve(entry.fvar_indices.size());
+        for (size_t k = 0; k < entry.face_order.size(); k++) {
+            int f = entry.face_order[k];
+            face_sizes.push_back(entry.face_sizes[f]);
+            for (int j = face_start[f]; j < face_start[f + 1]; j++) {
+                faces.push_back(rank[entry.faces[j]]);
+                if (fvar) {
+                    fvar_indices.push_back(entry.fvar_indices[j]);
+                }
+            }
+        }
+        entry.face_sizes.swap(face_sizes);
+        entry.faces.swap(faces);
+        entry.fvar_indices.swap(fvar_indices);
+
+        // -------- Edges (counting sort by the lower vertex) --------
+        std::vector<int> edge_start(entry.nn_verts + 1, 0);
+        for (int e = 0; e < entry.nn_edges; e++) {
+            edge_start[std::min(rank[entry.edges[2 * e]], rank[entry.edges[2 * e + 1]]) + 1]++;
+        }
+        for (int v = 0; v < entry.nn_verts; v++) {
+            edge_start[v + 1] += edge_start[v];
+        }
+        std::vector<int> edges(entry.edges.size());
+        for (int e = 0; e < entry.nn_edges; e++) {
+            int a = rank[entry.edges[2 * e]];
+            int b = rank[entry.edges[2 * e + 1]];
+            int slot = edge_start[std::min(a, b)]++;
+            edges[2 * slot] = a;
+            edges[2 * slot + 1] = b;
+        }
+        entry.edges.swap(edges);
+    }
+
+    // values[i] = values[order[i]], width Reals per vertex 
+    template <typename Real>
+    void permute_vertices(std::vector<int> const& order, int width, std::vector<Real>& values) {
+        if (values.empty() || width == 0) {
+            return;
+        }
+        std::vector<Real> source(values);
+        Real const* src = &source[0];
+        Real* dst = &values[0];
+        int const* from = &order[0];
+        parallel_chunks(order.size(), [&](int begin, int end) {
+            for (int i = begin; i < end; i++) {
+                std::copy(src + width * (size_t)from[i], src + width * (size_t)(from[i] + 1), dst + width * (size_t)i);
+            }
+        });
+    }
+
+    // Topology of the last refinement (shared with topology_cache, unless caching is off)
+    std::shared_ptr<topology_entry> current;
+
+    // ---------------- Stats ----------------
+    // The current (last) call, and everything before it 
+    subdivider_stats stats_last = subdivider_stats();
+    subdivider_stats stats_before = subdivider_stats();
+
+    void begin_stats() {
+        add_stats(stats_before, stats_last);
+        stats_last = subdivider_stats();
+    }
+
+    // Counts of a refine call, once current holds its topology (verts_out differs from current's at level 0) 
+    void record_refine_stats(int n_verts, int n_faces, int64_t verts_out, bool disk_hit) {
+        SUBDIVIDER_STAT(stats_last.calls = 1);
+        SUBDIVIDER_STAT(stats_last.disk_hits = disk_hit ? 1 : 0);
+        SUBDIVIDER_STAT(stats_last.cache_hits = cache_hit ? 1 : 0);
+        SUBDIVIDER_STAT(stats_last.verts_in = n_verts);
+        SUBDIVIDER_STAT(stats_last.faces_in = n_faces);
+        SUBDIVIDER_STAT(stats_last.verts_out = verts_out);
+        SUBDIVIDER_STAT(stats_last.edges_out = current->nn_edges);
+        SUBDIVIDER_STAT(stats_last.faces_out = current->nn_faces);
+        SUBDIVIDER_STAT(if (!cache_hit) stats_last.bytes_allocated += current->bytes());
+    }
+
+    int64_t result_bytes() const {
+        return vector_bytes(new_vertices) + vector_bytes(new_channels) + vector_bytes(new_fvar_values) 
+             + vector_bytes(control4) + vector_bytes(control4_d) + vector_bytes(control_interleaved) + vector_bytes(new_vertices_d);
+    }
+
+    // ---------------- Stencils ----------------
+    // Built once per topology, on the first stencil mode refinement 
+    Far::StencilTable const* last_level_stencils(topology_entry& entry) {
+        if (entry.stencils == NULL) {
+            Far::StencilTableFactory::Options options;
+            options.generateOffsets = true;
+            options.generateIntermediateLevels = false;
+            options.factorizeIntermediateLevels = true;
+            options.maxLevel = entry.maxlevel;
+            SUBDIVIDER_TIMER(stencil_timer, stencil_ms);
+            entry.stencils = Far::StencilTableFactory::Create(*entry.refiner, options);
+            SUBDIVIDER_STAT(stats_last.bytes_allocated += stencil_bytes(entry.stencils));
+        }
+        return entry.stencils;
+    }
+
+    Far::StencilTable const* last_level_fvar_stencils(topology_entry& entry) {
+        if (entry.fvar_stencils == NULL) {
+            Far::StencilTableFactory::Options options;
+            options.interpolationMode = Far::StencilTableFactory::INTERPOLATE_FACE_VARYING;
+            options.fvarChannel = 0;
+            options.generateOffsets = true;
+            options.generateIntermediateLevels = false;
+            options.factorizeIntermediateLevels = true;
+            options.maxLevel = entry.maxlevel;
+            SUBDIVIDER_TIMER(stencil_timer, stencil_ms);
+            entry.fvar_stencils = Far::StencilTableFactory::Create(*entry.refiner, options);
+            SUBDIVIDER_STAT(stats_last.bytes_allocated += stencil_bytes(entry.fvar_stencils));
+        }
+        return entry.fvar_stencils;
+    }
+
+    // Same as raw arrays, straight from the mapped file for entries loaded from the disk cache 
+    stencil_view vertex_stencils(topology_entry& entry) {
+        return entry.disk_file ? entry.disk_stencils : stencil_view(*last_level_stencils(entry));
+    }
+    stencil_view fvar_stencils(topology_entry& entry) {
+        return entry.disk_file ? entry.disk_fvar_stencils : stencil_view(*last_level_fvar_stencils(entry));
+    }
+
+    // ---------------- Disk cache ----------------
+    // Directory of the disk cache, empty when it's off (see set_disk_cache) 
+    std::string disk_cache_dir;
+
+    // Files are keyed without the result order: a reordered topology is saved (and its stencils are) in OpenSubdiv's 
+    // order and reordered once loaded, so both orders share one file. 
+    uint64_t disk_key(mesh_input const& mesh) const {
+        mesh_input unordered = mesh;
+        unordered.reorder = false;
+        return topology_key(unordered, maxlevel);
+    }
+
+    std::string disk_path(uint64_t key) const {
+        char name[32];
+        snprintf(name, sizeof(name), "%016llx.osdtopo", (unsigned long long)key);
+        return disk_cache_dir + "/" + name;
+    }
+
+    // Everything besides the faces themselves that a refined topology depends on 
+    void disk_settings(mesh_input const& mesh, int32_t settings[8]) const {
+        Sdc::Options options = scheme_options();
+        settings[0] = maxlevel;
+        settings[1] = (int)scheme_type();
+        settings[2] = (int)options.GetVtxBoundaryInterpolation();
+        settings[3] = (int)options.GetFVarLinearInterpolation();
+        settings[4] = mesh.n_verts;
+        settings[5] = mesh.n_faces;
+        settings[6] = mesh.n_faceVerts;
+        settings[7] = fvar_count(mesh);
+    }
+
+    // Writes a freshly refined topology, with its last level stencils, to the disk cache. 
+    // Only stencil mode refinements do: the stencils are what a loaded topology is evaluated with, and building them 
+    // for a level by level refinement would cost it more than the refinement itself. 
+    // It goes to a temporary file first and is renamed into place, so nobody ever maps half a file. 
+    void save_topology(topology_entry& entry, mesh_input const& mesh) {
+        if (entry.refiner == NULL || entry.maxlevel <= 0 || !use_stencils) {
+            return;
+        }
+        uint64_t key = disk_key(mesh);
+        Far::StencilTable const* stencils = last_level_stencils(entry);
+        Far::StencilTable const* fvar = entry.n_fvar_values > 0 ? last_level_fvar_stencils(entry) : NULL;
+
+        disk_header header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, disk_magic, sizeof(header.magic));
+        header.format_version = disk_format_version;
+        header.byte_order = disk_byte_order;
+        strncpy(header.osd_version, OPENSUBDIV_VERSION_STRING, sizeof(header.osd_version) - 1);
+        header.key = key;
+        disk_settings(mesh, header.settings);
+        header.nn_verts = entry.nn_verts;
+        header.nn_edges = entry.nn_edges;
+        header.nn_faces = entry.nn_faces;
+        header.nn_fvar_values = entry.nn_fvar_values;
+        header.n_stencils = stencils->GetNumStencils();
+        header.n_fvar_stencils = fvar ? fvar->GetNumStencils() : 0;
+
+        std::vector<int> const* sections[disk_n_sections] = {
+            &entry.faceVerts, &entry.vertsPerFace, &entry.fvar_indices_in, 
+            &entry.edges, &entry.face_sizes, &entry.faces, &entry.fvar_indices, 
+            &stencils->GetSizes(), &stencils->GetOffsets(), &stencils->GetControlIndices(), NULL, 
+            fvar ? &fvar->GetSizes() : NULL, fvar ? &fvar->GetOffsets() : NULL, fvar ? &fvar->GetControlIndices() : NULL, NULL 
+        };
+        char const* data[disk_n_sections];
+        uint64_t offset = disk_padded(sizeof(disk_header));
+        for (int i = 0; i < disk_n_sections; i++) {
+            data[i] = NULL;
+            header.count[i] = 0;
+            if (sections[i] != NULL && !sections[i]->empty()) {
+                data[i] = (char const*)&(*sections[i])[0];
+                header.count[i] = sections[i]->size();
+            }
+        }
+        if (!stencils->GetWeights().empty()) {
+            data[disk_stencil_weights] = (char const*)&stencils->GetWeights()[0];
+            header.count[disk_stencil_weights] = stencils->GetWeights().size();
+        }
+        if (fvar != NULL && !fvar->GetWeights().empty()) {
+            data[disk_fvar_stencil_weights] = (char const*)&fvar->GetWeights()[0];
+            header.count[disk_fvar_stencil_weights] = fvar->GetWeights().size();
+        }
+        for (int i = 0; i < disk_n_sections; i++) {
+            header.offset[i] = offset;
+            offset += disk_padded(4 * header.count[i]);
+        }
+
+        char suffix[64];
+        snprintf(suffix, sizeof(suffix), ".%llx.tmp", (unsigned long long)std::chrono::steady_clock::now().time_since_epoch().count() ^ (unsigned long long)(uintptr_t)this);
+        std::string path = disk_path(key);
+        std::string temporary = path + suffix;
+        FILE* file = fopen(temporary.c_str(), "wb");
+        if (file == NULL) {
+            return;
+        }
+        // Header last, once the checksum is known 
+        static const char zeros[8] = { 0 };
+        bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+        ok = ok && fwrite(zeros, 1, disk_padded(sizeof(header)) - sizeof(header), file) == disk_padded(sizeof(header)) - sizeof(header);
+        uint64_t checksum = disk_checksum_start;
+        for (int i = 0; i < disk_n_sections && ok; i++) {
+            size_t bytes = 4 * header.count[i];
+            if (bytes > 0) {
+                ok = fwrite(data[i], 1, bytes, file) == bytes;
+                ok = ok && fwrite(zeros, 1, disk_padded(bytes) - bytes, file) == disk_padded(bytes) - bytes;
+                checksum = disk_checksum(checksum, data[i], bytes);
+            }
+        }
+        header.checksum = checksum;
+        ok = ok && fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1;
+        ok = fclose(file) == 0 && ok;
+        if (ok) {
+#ifdef _WIN32
+            // rename doesn't replace existing files there 
+            remove(path.c_str());
+#endif
+            ok = rename(temporary.c_str(), path.c_str()) == 0;
+        }
+        if (!ok) {
+            remove(temporary.c_str());
+        }
+    }
+
+    // The disk cache's copy of this mesh's topology (at the current settings), or NULL if there is none. 
+    // Files from another OpenSubdiv version, format version or settings, damaged ones (checksum) 
+    // and hash collisions (the incoming faces are compared) are all ignored, and overwritten by save_topology. 
+    // key is the in-memory one (topology_key) the entry goes into the cache under. 
+    std::shared_ptr<topology_entry> load_topology(uint64_t key, mesh_input const& mesh) {
+        uint64_t file_key = disk_key(mesh);
+        std::shared_ptr<mapped_file> file(new mapped_file(disk_path(file_key).c_str()));
+        size_t size = file->end - file->begin;
+        if (!file->ok() || size < sizeof(disk_header)) {
+            return NULL;
+        }
+        disk_header header;
+        memcpy(&header, file->begin, sizeof(header));
+        int32_t settings[8];
+        disk_settings(mesh, settings);
+        if (memcmp(header.magic, disk_magic, sizeof(header.magic)) != 0 
+            || header.format_version != disk_format_version 
+            || header.byte_order != disk_byte_order 
+            || strncmp(header.osd_version, OPENSUBDIV_VERSION_STRING, sizeof(header.osd_version)) != 0 
+            || header.key != file_key 
+            || memcmp(header.settings, settings, sizeof(settings)) != 0) {
+            return NULL;
+        }
+
+        // Sizes implied by the mesh and the header 
+        bool fvar = fvar_count(mesh) > 0;
+        int64_t expected[disk_n_sections] = {
+            mesh.n_faceVerts, mesh.n_faces, fvar ? mesh.n_faceVerts : 0, 
+            2 * (int64_t)header.nn_edges, header.nn_faces, -1, fvar ? (int64_t)header.count[disk_faces] : 0, 
+            header.n_stencils, header.n_stencils, -1, (int64_t)header.count[disk_stencil_indices], 
+            header.n_fvar_stencils, header.n_fvar_stencils, -1, (int64_t)header.count[disk_fvar_stencil_indices] 
+        };
+        uint64_t offset = disk_padded(sizeof(disk_header));
+        for (int i = 0; i < disk_n_sections; i++) {
+            if (header.offset[i] != offset || header.count[i] > (size - offset) / 4 
+                || (expected[i] >= 0 && (int64_t)header.count[i] != expected[i])) {
+                return NULL;
+            }
+            offset += disk_padded(4 * header.count[i]);
+        }
+        if (offset != size || header.n_stencils != header.nn_verts || (fvar && header.n_fvar_stencils != header.nn_fvar_values)) {
+            return NULL;
+        }
+        char const* payload = file->begin + disk_padded(sizeof(disk_header));
+        if (disk_checksum(disk_checksum_start, payload, file->end - payload) != header.checksum) {
+            return NULL;
+        }
+
+        int const* section[disk_n_sections];
+        for (int i = 0; i < disk_n_sections; i++) {
+            section[i] = (int const*)(file->begin + header.offset[i]);
+        }
+        // Same faces, not just the same hash 
+        if (!std::equal(section[disk_vertsPerFace], section[disk_vertsPerFace] + mesh.n_faces, mesh.vertsPerFace) 
+            || !std::equal(section[disk_faceVerts], section[disk_faceVerts] + mesh.n_faceVerts, mesh.faceVerts) 
+            || (fvar && !std::equal(section[disk_fvar_indices_in], section[disk_fvar_indices_in] + mesh.n_faceVerts, mesh.fvar_indices))) {
+            return NULL;
+        }
+
+        std::shared_ptr<topology_entry> entry = std::make_shared<topology_entry>();
+        entry->key = key;
+        stamp_scheme(*entry);
+        entry->n_verts = mesh.n_verts;
+        entry->maxlevel = maxlevel;
+        entry->faceVerts.assign(mesh.faceVerts, mesh.faceVerts + mesh.n_faceVerts);
+        entry->vertsPerFace.assign(mesh.vertsPerFace, mesh.vertsPerFace + mesh.n_faces);
+        entry->n_fvar_values = fvar_count(mesh);
+        if (fvar) {
+            entry->fvar_indices_in.assign(mesh.fvar_indices, mesh.fvar_indices + mesh.n_faceVerts);
+        }
+        entry->nn_verts = header.nn_verts;
+        entry->nn_edges = header.nn_edges;
+        entry->nn_faces = header.nn_faces;
+        entry->nn_fvar_values = header.nn_fvar_values;
+        entry->edges.assign(section[disk_edges], section[disk_edges] + header.count[disk_edges]);
+        entry->face_sizes.assign(section[disk_face_sizes], section[disk_face_sizes] + header.count[disk_face_sizes]);
+        entry->faces.assign(section[disk_faces], section[disk_faces] + header.count[disk_faces]);
+        entry->fvar_indices.assign(section[disk_fvar_indices], section[disk_fvar_indices] + header.count[disk_fvar_indices]);
+
+        entry->disk_stencils.n_stencils = header.n_stencils;
+        entry->disk_stencils.sizes = section[disk_stencil_sizes];
+        entry->disk_stencils.offsets = section[disk_stencil_offsets];
+        entry->disk_stencils.indices = section[disk_stencil_indices];
+        entry->disk_stencils.weights = (float const*)section[disk_stencil_weights];
+        entry->disk_fvar_stencils.n_stencils = header.n_fvar_stencils;
+        entry->disk_fvar_stencils.sizes = section[disk_fvar_stencil_sizes];
+        entry->disk_fvar_stencils.offsets = section[disk_fvar_stencil_offsets];
+        entry->disk_fvar_stencils.indices = section[disk_fvar_stencil_indices];
+        entry->disk_fvar_stencils.weights = (float const*)section[disk_fvar_stencil_weights];
+        entry->disk_file = file;
+        return entry;
+    }
+
+    // Largest level (vertex count, or face-varying value count) among levels 0 .. maxlevel - 1 of one parity, 
+    // i.e. what one of the two level-by-level interpolation buffers has to hold. 
+    static int ping_pong_size(Far::TopologyRefiner const& refiner, int maxlevel, int parity, bool fvar) {
+        int size = 0;
+        for (int level = parity; level < maxlevel; level += 2) {
+            Far::TopologyLevel const& refLevel = refiner.GetLevel(level);
+            size = std::max(size, fvar ? refLevel.GetNumFVarValues(0) : refLevel.GetNumVertices());
+        }
+        return size;
+    }
+
+    // ---------------- Limit surface ----------------
+    // Limit entries share the topology cache with the uniform ones, under a level no uniform entry can have. 
+    static int limit_entry_level(int isolation) {
+        return -1 - isolation;
+    }
+
+    // Adaptive refinement around the extraordinary features (up to limit_isolation), 
+    // then the patches covering the whole limit surface and the stencils of their control points. 
+    std::shared_ptr<topology_entry> build_limit_topology(uint64_t key, mesh_input const& mesh) {
+        std::shared_ptr<topology_entry> entry = std::make_shared<topology_entry>();
+        entry->key = key;
+        stamp_scheme(*entry);
+        entry->n_verts = mesh.n_verts;
+        entry->maxlevel = limit_entry_level(limit_isolation);
+        entry->faceVerts.assign(mesh.faceVerts, mesh.faceVerts + mesh.n_faceVerts);
+        entry->vertsPerFace.assign(mesh.vertsPerFace, mesh.vertsPerFace + mesh.n_faces);
+
+        Far::TopologyRefiner* refiner = create_refiner(mesh);
+        if (refiner == NULL) {
+            return entry;
+        }
+        // Infinitely sharp patches have to be asked for both here and from the PatchTableFactory 
+        Far::TopologyRefiner::AdaptiveOptions refine_options(limit_isolation);
+        refine_options.useInfSharpPatch = true;
+        refiner->RefineAdaptive(refine_options);
+        entry->refiner = refiner;
+
+        Far::PatchTableFactory::Options patch_options(limit_isolation);
+        patch_options.useInfSharpPatch = true;
+        patch_options.SetEndCapType(Far::PatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+        entry->patches = Far::PatchTableFactory::Create(*refiner, patch_options);
+        entry->patch_map = new Far::PatchMap(*entry->patches);
+        entry->n_ptex_faces = Far::PtexIndices(*refiner).GetNumFaces();
+
+        Far::StencilTableFactory::Options options;
+        options.generateOffsets = true;
+        options.generateIntermediateLevels = true;
+        options.factorizeIntermediateLevels = true;
+        Far::StencilTable const* stencils = Far::StencilTableFactory::Create(*refiner, options);
+        if (Far::StencilTable const* local_points = entry->patches->GetLocalPointStencilTable()) {
+            Far::StencilTable const* combined = Far::StencilTableFactory::AppendLocalPointStencilTable(*refiner, stencils, local_points);
+            if (combined != NULL) {
+                delete stencils;
+                stencils = combined;
+            }
+        }
+        entry->stencils = stencils;
+        return entry;
+    }
+
+    // Patch control points of the last limit evaluation ([control vertices, refined vertices, local points], flat xyz) 
+    std::vector<float> limit_points;
+    // Its padded control vertices (control4 belongs to the last refinement, see update_vertices) 
+    std::vector<float> limit_control4;
+
+    // Interleaved [x, y, z, channels...] copy of the control vertices, when there are extra channels 
+    std::vector<float> control_interleaved;
+
+    // Padded (x, y, z, 0) copy of the control vertices for gather_stencils
+    std::vector<float> control4;
+    std::vector<double> control4_d;
+
+    // ---------------- Incremental update ----------------
+    // Whether the results can be updated in place (see update_vertices), 
+    // i.e. there was a stencil (or level 0) refinement and control4 / control4_d hold its control positions 
+    bool updatable = false;
+    // Sorted refined vertices changed by the last update_vertices 
+    std::vector<int> dirty_vertices;
+    // dirty_stamp[i] == dirty_generation marks refined vertex i as already collected by the current update 
+    std::vector<uint32_t> dirty_stamp;
+    uint32_t dirty_generation = 0;
+
+    void pad_control_positions(mesh_input const& mesh, bool double_precision) {
+        int n_verts = mesh.n_verts;
+        if (double_precision) {
+            control4.clear();
+            control4_d.resize(4 * (size_t)n_verts);
+            double* padded = control4_d.data();
+            parallel_chunks(n_verts, [&](int begin, int end) {
+                for (int i = begin; i < end; i++) {
+                    padded[4 * i + 0] = mesh.position(i, 0);
+                    padded[4 * i + 1] = mesh.position(i, 1);
+                    padded[4 * i + 2] = mesh.position(i, 2);
+                    padded[4 * i + 3] = 0.0;
+                }
+            });
+        } else {
+            control4_d.clear();
+            control4.resize(4 * (size_t)n_verts);
+            float* padded = control4.data();
+            float (*vertices)[3] = mesh.vertices;
+            parallel_chunks(n_verts, [&](int begin, int end) {
+                for (int i = begin; i < end; i++) {
+                    padded[4 * i + 0] = vertices[i][0];
+                    padded[4 * i + 1] = vertices[i][1];
+                    padded[4 * i + 2] = vertices[i][2];
+                    padded[4 * i + 3] = 0.0f;
+                }
+            });
+        }
+    }
+
+    static void build_inverse_stencils(topology_entry& entry, stencil_view const& stencils) {
+        if (!entry.inverse_offsets.empty()) {
+            return;
+        }
+        std::vector<int>& offsets = entry.inverse_offsets;
+        offsets.assign(entry.n_verts + 1, 0);
+        for (int i = 0; i < stencils.n_stencils; i++) {
+            int const* index = stencils.indices + stencils.offsets[i];
+            for (int j = 0; j < stencils.sizes[i]; j++) {
+                offsets[index[j] + 1]++;
+            }
+        }
+        for (int c = 0; c < entry.n_verts; c++) {
+            offsets[c + 1] += offsets[c];
+        }
+        // Refined vertices in increasing order within every control vertex 
+        std::vector<int> fill(offsets.begin(), offsets.end() - 1);
+        entry.inverse_stencils.resize(offsets.back());
+        for (int i = 0; i < stencils.n_stencils; i++) {
+            int const* index = stencils.indices + stencils.offsets[i];
+            for (int j = 0; j < stencils.sizes[i]; j++) {
+                entry.inverse_stencils[fill[index[j]]++] = i;
+            }
+        }
+    }
+
+    // Marks refined vertex i as dirty, once per update 
+    void mark_dirty(int i) {
+        if (dirty_stamp[i] != dirty_generation) {
+            dirty_stamp[i] = dirty_generation;
+            dirty_vertices.push_back(i);
+        }
+    }
+
+    // ---------------- Batch ----------------
+    // One subdivider per mesh of the batch, so each mesh keeps its own topology cache from call to call 
+    std::vector<std::unique_ptr<subdivider>> batch_items;
+
+    std::unique_ptr<task_pool> pool;
+    task_pool& thread_pool() {
+        int n_threads = threads > 0 ? threads : hardware_threads();
+        if (!pool || pool->size() != n_threads) {
+            pool.reset(new task_pool(n_threads));
+        }
+        return *pool;
+    }
+
+    // Splits [0, n) into fixed size chunks and runs fn(begin, end) on them across the pool. 
+    // The chunks don't depend on the thread count and each element is computed exactly as in the serial loop, 
+    // so the results are bit-identical whatever the number of threads. 
+    // A cancelled job (see submit) skips the chunks left.
+    void parallel_chunks(int n, std::function<void(int, int)> const& fn) {
+        const int chunk = 4096;
+        int n_chunks = (n + chunk - 1) / chunk;
+        if (threads == 1 || n_chunks <= 1) {
+            for (int c = 0; c < n_chunks && !cancelled(); c++) {
+                fn(c * chunk, std::min(n, (c + 1) * chunk));
+            }
+            return;
+        }
+        thread_pool().parallel_for(n_chunks, [&](int c) {
+            if (!cancelled()) {
+                fn(c * chunk, std::min(n, (c + 1) * chunk));
+            }
+        });
+    }
+
+    // ---------------- Async jobs ----------------
+    // Set while async_engine runs a job, see submit
+    std::atomic<bool> const* cancel_flag = NULL;
+
+    bool cancelled() const {
+        return cancel_flag != NULL && cancel_flag->load(std::memory_order_relaxed);
+    }
+
+    // Runs the submitted jobs one after the other on async_thread, with a topology cache of its own
+    std::unique_ptr<subdivider> async_engine;
+    std::thread async_thread;
+    bool async_stop = false;
+    int64_t last_ticket = 0;
+    // Every job until it's collected or released, and the ones still waiting for the worker
+    std::map<int64_t, std::shared_ptr<refine_job>> jobs;
+    std::deque<std::shared_ptr<refine_job>> job_queue;
+    std::mutex job_mutex;
+    std::condition_variable job_wake;
+    std::condition_variable job_finished;
+
+    void async_loop() {
+        std::unique_lock<std::mutex> lock(job_mutex);
+        while (true) {
+            job_wake.wait(lock, [this] { return async_stop || !job_queue.empty(); });
+            if (async_stop) {
+                return;
+            }
+            std::shared_ptr<refine_job> job = job_queue.front();
+            job_queue.pop_front();
+            if (job->status != job_pending) {
+                // Cancelled while it was waiting
+                continue;
+            }
+            job->status = job_running;
+            lock.unlock();
+            int status = run_job(*job);
+            lock.lock();
+            job->status = status;
+            job_finished.notify_all();
+        }
+    }
+
+    int run_job(refine_job& job) {
+        subdivider& engine = *async_engine;
+        engine.settings(job.maxlevel, false, job.threads);
+        engine.set_scheme(job.scheme);
+        engine.set_cache_size(job.cache_size);
+        engine.set_stencils(job.use_stencils);
+        engine.set_precision(job.use_double);
+        engine.set_reorder(job.reorder);
+        engine.set_disk_cache(job.disk_cache_dir.c_str());
+
+        engine.cancel_flag = &job.cancel;
+        try {
+            engine.refine_topology(job.n_verts, job.n_faces, (float (*)[3])(job.vertices.empty() ? NULL : &job.vertices[0]),
+                                   job.faceVerts.empty() ? NULL : &job.faceVerts[0], job.vertsPerFace.empty() ? NULL : &job.vertsPerFace[0]);
+        } catch (std::exception const&) {
+            // Out of memory, most likely. The engine's results are reset by its next refinement.
+            engine.cancel_flag = NULL;
+            return job_failed;
+        }
+        engine.cancel_flag = NULL;
+
+        // The input isn't needed anymore either way
+        std::vector<float>().swap(job.vertices);
+        std::vector<int>().swap(job.faceVerts);
+        std::vector<int>().swap(job.vertsPerFace);
+        if (job.cancel) {
+            return job_cancelled;
+        }
+        job.entry = engine.current;
+        job.nn_verts = engine.nn_verts;
+        job.nn_edges = engine.nn_edges;
+        job.nn_faces = engine.nn_faces;
+        job.nn_face_verts = engine.nn_face_verts;
+        job.cache_hit = engine.cache_hit;
+        job.disk_hit = engine.disk_hit;
+        job.new_vertices.swap(engine.new_vertices);
+        job.new_vertices_d.swap(engine.new_vertices_d);
+        job.stats = engine.stats_last;
+        return job_done;
+    }
+
+    // Needs job_mutex. Pending jobs are dropped right away, a running one stops at its next check.
+    void cancel_job(refine_job& job) {
+        job.cancel = true;
+        if (job.status == job_pending) {
+            job.status = job_cancelled;
+            std::vector<float>().swap(job.vertices);
+            std::vector<int>().swap(job.faceVerts);
+            std::vector<int>().swap(job.vertsPerFace);
+            job_finished.notify_all();
+        }
+    }
+
+    void stop_async() {
+        if (!async_thread.joinable()) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(job_mutex);
+            async_stop = true;
+            for (std::map<int64_t, std::shared_ptr<refine_job>>::iterator it = jobs.begin(); it != jobs.end(); ++it) {
+                cancel_job(*it->second);
+            }
+        }
+        job_wake.notify_all();
+        async_thread.join();
+    }
+
+public:
+    subdivider() {        
+        nn_verts = 0;
+        nn_edges = 0;
+        nn_faces = 0;
+        nn_face_verts = 0;
+        new_vertices.clear();
+    }
+
+    ~subdivider() {
+        stop_async();
+    }
+
+    int maxlevel = 0; 
+    int verbose = false; 
+    // Subdivision scheme, an Sdc::SchemeType (0 = Bilinear, 1 = CatMark, 2 = Loop, which needs an all-triangle mesh) 
+    int scheme = Sdc::SCHEME_CATMARK;
+    // Worker threads for the batch and stencil evaluation (0 = one per core, 1 = everything on the calling thread). 
+    // Level by level interpolation (PrimvarRefiner::Interpolate) can't be split up and always runs on one thread. 
+    int threads = 0;
+    // Number of topologies kept around (0 turns caching off, which also frees each refinement as soon as its results are out) 
+    int cache_size = 8;
+    // Whether the last refine_topology call reused a cached topology 
+    int cache_hit = false;
+    // Whether it came from the disk cache (see set_disk_cache) 
+    int disk_hit = false;
+    // Evaluate through a last-level stencil table instead of level by level. 
+    // Building the table costs more than one level-by-level refinement, 
+    // so this pays off when the same topology is refined repeatedly (see topology_entry). 
+    int use_stencils = false;
+    // Interpolate the positions in double precision (set_precision, always on for refine_topology_d). 
+    // Extra channels and face-varying values stay in float. 
+    int use_double = false;
+    // Hand out uniform refinements in a cache-friendly order (see set_reorder) 
+    int reorder = false;
+    // Adaptive refinement depth around extraordinary vertices and creases for limit evaluation (evaluate_limit). 
+    // Regular regions are exact at any depth, this only bounds the error of the Gregory patches left around the features. 
+    int limit_isolation = 4;
+
+    // outgoing topology 
+    int nn_verts;
+    int nn_edges;
+    int nn_faces;
+    // Total size of the faces (sum of the face sizes), see export_faces 
+    int nn_face_verts;
+    // Flat x, y, z 
+    std::vector<float> new_vertices;
+    // Same in double precision, only filled when the positions were interpolated in double (see export_vertices_d) 
+    std::vector<double> new_vertices_d;
+    // outgoing primvars (see refine_primvars): n_channels floats per new vertex, 
+    // nn_fvar_values face-varying values of fvar_width floats, indexed by current->fvar_indices 
+    int n_channels = 0;
+    int fvar_width = 0;
+    int nn_fvar_values = 0;
+    std::vector<float> new_channels;
+    std::vector<float> new_fvar_values;
+
+    // outgoing batch topology, n_meshes + 1 offsets each (in vertices, edges, faces and face-vertices)
+    std::vector<int> batch_vert_offsets;
+    std::vector<int> batch_edge_offsets;
+    std::vector<int> batch_face_offsets;
+    std::vector<int> batch_face_vert_offsets;
+
+    // ---------------- Configure ----------------
+    void settings(int maxlevel,int verbose,int threads = 0){
+        if(maxlevel < 0){
+            maxlevel = 0;
+        }
+        if(threads < 0){
+            threads = 0;
+        }
+        this->maxlevel = maxlevel;
+        this->verbose = verbose;
+        this->threads = threads;
+    }
+
+    void set_scheme(int scheme){
+        if(scheme < Sdc::SCHEME_BILINEAR || scheme > Sdc::SCHEME_LOOP){
+            scheme = Sdc::SCHEME_CATMARK;
+        }
+        this->scheme = scheme;
+    }
+
+    void set_stencils(int use_stencils){
+        this->use_stencils = use_stencils;
+    }
+
+    // Keeps refined topologies (and their last level stencils) in `directory` as well, across sessions and processes. 
+    // Stencil mode refinements (set_stencils) write them, every refinement reads them: a topology found there is mapped 
+    // instead of refined, and evaluated through its stencils whatever use_stencils says. 
+    // The directory has to exist; NULL or "" turns the disk cache off. 
+    void set_disk_cache(char const* directory){
+        disk_cache_dir = directory != NULL ? directory : "";
+    }
+
+    void set_precision(int use_double){
+        this->use_double = use_double;
+    }
+
+    // Renumbers the refined faces of refine_topology / refine_primvars / refine_batch for the vertex cache 
+    // (see vertex_cache_order) and the refined vertices by first use along them, instead of OpenSubdiv's order, 
+    // which groups the vertices by what they came from (faces, edges, vertices) far apart from their neighbours. 
+    // Done once per topology (it's cached with it); every refinement then pays one more pass over its vertices. 
+    // export_order has the permutations. Level 0 results are the incoming mesh and keep its order. 
+    void set_reorder(int reorder){
+        this->reorder = reorder;
+    }
+
+    void set_limit_isolation(int limit_isolation){
+        // Far::PatchTableFactory keeps the isolation level in 4 bits 
+        this->limit_isolation = std::max(1, std::min(limit_isolation, 10));
+    }
+
+    void set_cache_size(int cache_size){
+        if(cache_size < 0){
+            cache_size = 0;
+        }
+        this->cache_size = cache_size;
+        trim_cache();
+    }
+
+    // ---------------- Stats ----------------
+    // Stats of the last call (including the copy-out after it) and the running totals since the last reset 
+    void get_stats(subdivider_stats* last, subdivider_stats* total) const {
+        if (last != NULL) {
+            *last = stats_last;
+        }
+        if (total != NULL) {
+            *total = stats_before;
+            add_stats(*total, stats_last);
+        }
+    }
+
+    void reset_stats() {
+        stats_last = subdivider_stats();
+        stats_before = subdivider_stats();
+    }
+
+    // ---------------- Cache control ----------------
+    // Drop every cached topology.
+    void invalidate_cache(){
+        topology_cache.clear();
+    }
+
+    // Drop the cached topology (at the current settings) of this mesh, if there is one. 
+    // Meshes refined with a face-varying channel are keyed on its indices too and need evict_mesh. 
+    int evict_topology(int n_verts, int n_faces, int* faceVerts, int* vertsPerFace){
+        mesh_input mesh;
+        mesh.n_verts = n_verts;
+        mesh.n_faces = n_faces;
+        mesh.faceVerts = faceVerts;
+        mesh.vertsPerFace = vertsPerFace;
+        mesh.reorder = reorder != 0;
+        mesh.count_faceVerts();
+        return evict_mesh(mesh);
+    }
+
+    int evict_mesh(mesh_input const& mesh){
+        uint64_t key = topology_key(mesh, maxlevel);
+        std::list<std::shared_ptr<topology_entry>>::iterator it = find_topology(key, mesh, maxlevel);
+        if (it == topology_cache.end()) {
+            return false;
+        }
+        topology_cache.erase(it);
+        return true;
+    }
+
+    int cached_topologies(){
+        return topology_cache.size();
+    }
+
+    // ---------------- Misc ----------------
+    void print_settings(){
+        std::cout << maxlevel << std::endl;
+        std::cout << verbose << std::endl;
+    }
+
+    // ---------------- Return new mesh info ----------------
+    std::vector<int> refinement_info() {
+        std::vector<int> info;
+        info.reserve(3);
+        info.push_back(nn_verts);
+        info.push_back(nn_edges);
+        info.push_back(nn_faces);
+        return info;
+    }
+
+    // ---------------- Return New Vertices ----------------
+    void return_new_vertices(float py_new_vertices[][3]) {
+        SUBDIVIDER_TIMER(copyout_timer, copyout_ms);
+        std::copy(new_vertices.begin(), new_vertices.end(), &py_new_vertices[0][0]);
+    }
+
+    // ---------------- Return New Edges ----------------
+    // These and the exports below write nothing before the first refinement. 
+    void return_new_edges(int py_new_edges[][2]) {
+        SUBDIVIDER_TIMER(copyout_timer, copyout_ms);
+        if (!current) {
+            return;
+        }
+        std::copy(current->edges.begin(), current->edges.end(), &py_new_edges[0][0]);
+    }
+    // ---------------- Return New Faces ----------------
+    // Quads only, i.e. CatMark or Bilinear with maxlevel > 0 (export_faces takes any faces) 
+    void return_new_faces(int py_new_faces[][4]) {
+        SUBDIVIDER_TIMER(copyout_timer, copyout_ms);
+        if (!current) {
+            return;
+        }
+        std::copy(current->faces.begin(), current->faces.end(), &py_new_faces[0][0]);
+    }
+
+    // Faces in CSR form, nn_faces sizes and nn_face_verts vertex indices, either can be NULL to skip it. 
+    void export_faces(int* py_vertsPerFace, int* py_faceVerts) {
+        SUBDIVIDER_TIMER(copyout_timer, copyout_ms);
+        if (!current) {
+            return;
+        }
+        if (py_vertsPerFace) {
+            std::copy(current->face_sizes.begin(), current->face_sizes.end(), py_vertsPerFace);
+        }
+        if (py_faceVerts) {
+            std::copy(current->faces.begin(), current->faces.end(), py_faceVerts);
+        }
+    }
+
+    // ---------------- Export everything ----------------
+    // One call for all three, any of the buffers can be NULL to skip it. 
+    // Sizes are nn_verts*3 floats, nn_edges*2 ints and nn_face_verts ints (the faces' vertices back to back, 
+    // i.e. nn_faces*4 for quads; export_faces has the face sizes). 
+    void export_mesh(float* py_vertices, int* py_edges, int* py_faces) {
+        SUBDIVIDER_TIMER(copyout_timer, copyout_ms);
+        if (py_vertices) {
+            std::copy(new_vertices.begin(), new_vertices.end(), py_vertices);
+        }
+        if (py_edges && current) {
+            std::copy(current->edges.begin(), current->edges.end(), py_edges);
+        }
+        if (py_faces && current) {
+            std::copy(current->faces.begin(), current->faces.end(), py_faces);
+        }
+    }
+
+    // Pointers to the results themselves (no copy). 
+    // They stay valid until the next refine_topology call. 
+    void result_buffers(float** py_vertices, int** py_edges, int** py_faces, int** py_face_sizes) {
+        *py_vertices = new_vertices.empty() ? NULL : &new_vertices[0];
+        *py_edges = !current || current->edges.empty() ? NULL : &current->edges[0];
+        *py_faces = !current || current->faces.empty() ? NULL : &current->faces[0];
+        *py_face_sizes = !current || current->face_sizes.empty() ? NULL : &current->face_sizes[0];
+    }
+
+    // Faces of the last refinement in CSR form, without copying them out (see export_faces) 
+    std::vector<int> const& result_face_sizes() const {
+        return current ? current->face_sizes : no_results();
+    }
+
+    std::vector<int> const& result_faces() const {
+        return current ? current->faces : no_results();
+    }
+
+    // ---------------- Batch ----------------
+    // Subdivides n_meshes meshes in parallel. The input is concatenated: mesh m owns 
+    // vertices [vert_offsets[m], vert_offsets[m+1]) and faces (vertsPerFace) [face_offsets[m], face_offsets[m+1]), 
+    // its faceVerts follow each other in the same order and index its own vertices (i.e. start at 0 for every mesh). 
+    // n_verts, n_faces and n_faceVerts are the lengths of the concatenated arrays, the offsets have to stay within them. 
+    // Returns false (and leaves an empty batch) if the offsets don't fit. 
+    bool refine_batch(int n_meshes, int* vert_offsets, int* face_offsets, int n_verts, int n_faces, int n_faceVerts, 
+                      float vertices[][3], int* faceVerts, int* vertsPerFace) {
+        batch_vert_offsets.assign(1, 0);
+        batch_edge_offsets.assign(1, 0);
+        batch_face_offsets.assign(1, 0);
+        batch_face_vert_offsets.assign(1, 0);
+        if (!valid_batch(n_meshes, vert_offsets, face_offsets, n_verts, n_faces, vertsPerFace)) {
+            batch_items.clear();
+            return false;
+        }
+
+        SUBDIVIDER_STAT(begin_stats());
+        SUBDIVIDER_TIMER(total_timer, total_ms);
+        std::vector<int64_t> faceVert_offsets(n_meshes + 1, 0);
+        for (int m = 0; m < n_meshes; m++) {
+            int64_t mesh_faceVerts = 0;
+            for (int i = face_offsets[m]; i < face_offsets[m + 1]; i++) {
+                mesh_faceVerts += vertsPerFace[i];
+            }
+            faceVert_offsets[m + 1] = faceVert_offsets[m] + mesh_faceVerts;
+        }
+        if (faceVert_offsets[n_meshes] > n_faceVerts) {
+            batch_items.clear();
+            return false;
+        }
+
+        batch_items.resize(n_meshes);
+        for (int m = 0; m < n_meshes; m++) {
+            if (!batch_items[m]) {
+                batch_items[m].reset(new subdivider());
+            }
+            subdivider& item = *batch_items[m];
+            // The meshes are already spread over the pool 
+            item.settings(maxlevel, false, 1);
+            item.set_scheme(scheme);
+            item.set_cache_size(cache_size);
+            item.set_stencils(use_stencils);
+            item.set_precision(use_double);
+            item.set_reorder(reorder);
+            item.set_disk_cache(disk_cache_dir.c_str());
+        }
+
+        thread_pool().parallel_for(n_meshes, [&](int m) {
+            batch_items[m]->refine_topology(
+                vert_offsets[m + 1] - vert_offsets[m], 
+                face_offsets[m + 1] - face_offsets[m], 
+                vertices + vert_offsets[m], 
+                faceVerts + faceVert_offsets[m], 
+                vertsPerFace + face_offsets[m]);
+        });
+
+        batch_vert_offsets.assign(n_meshes + 1, 0);
+        batch_edge_offsets.assign(n_meshes + 1, 0);
+        batch_face_offsets.assign(n_meshes + 1, 0);
+        batch_face_vert_offsets.assign(n_meshes + 1, 0);
+        for (int m = 0; m < n_meshes; m++) {
+            batch_vert_offsets[m + 1] = batch_vert_offsets[m] + batch_items[m]->nn_verts;
+            batch_edge_offsets[m + 1] = batch_edge_offsets[m] + batch_items[m]->nn_edges;
+            batch_face_offsets[m + 1] = batch_face_offsets[m] + batch_items[m]->nn_faces;
+            batch_face_vert_offsets[m + 1] = batch_face_vert_offsets[m] + batch_items[m]->nn_face_verts;
+        }
+
+        // One batch is one call, its stages are summed over the meshes 
+        SUBDIVIDER_STAT(for (int m = 0; m < n_meshes; m++) add_stats(stats_last, batch_items[m]->stats_last));
+        SUBDIVIDER_STAT(stats_last.calls = 1);
+        SUBDIVIDER_STAT(stats_last.total_ms = 0);
+        return true;
+    }
+
+    // Offsets within the input that never decrease, and face sizes that aren't negative 
+    static bool valid_batch(int n_meshes, int const* vert_offsets, int const* face_offsets, int n_verts, int n_faces, int const* vertsPerFace) {
+        if (n_meshes <= 0) {
+            return n_meshes == 0;
+        }
+        for (int m = 0; m <= n_meshes; m++) {
+            if (vert_offsets[m] < 0 || vert_offsets[m] > n_verts || (m > 0 && vert_offsets[m] < vert_offsets[m - 1])) {
+                return false;
+            }
+            if (face_offsets[m] < 0 || face_offsets[m] > n_faces || (m > 0 && face_offsets[m] < face_offsets[m - 1])) {
+                return false;
+            }
+        }
+        for (int i = face_offsets[0]; i < face_offsets[n_meshes]; i++) {
+            if (vertsPerFace[i] < 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void return_batch_offsets(int* py_vert_offsets, int* py_edge_offsets, int* py_face_offsets, int* py_face_vert_offsets) {
+        std::copy(batch_vert_offsets.begin(), batch_vert_offsets.end(), py_vert_offsets);
+        std::copy(batch_edge_offsets.begin(), batch_edge_offsets.end(), py_edge_offsets);
+        std::copy(batch_face_offsets.begin(), batch_face_offsets.end(), py_face_offsets);
+        std::copy(batch_face_vert_offsets.begin(), batch_face_vert_offsets.end(), py_face_vert_offsets);
+    }
+
+    // Concatenated results, laid out by the batch offsets (faces in CSR form, like export_faces). 
+    // Edge and face vertex indices stay local to their mesh (like the input). 
+    void export_batch(float* py_vertices, int* py_edges, int* py_face_sizes, int* py_faces) {
+        thread_pool().parallel_for(batch_items.size(), [&](int m) {
+            batch_items[m]->export_mesh(
+                py_vertices ? py_vertices + 3 * (size_t)batch_vert_offsets[m] : NULL, 
+                py_edges ? py_edges + 2 * (size_t)batch_edge_offsets[m] : NULL, 
+                NULL);
+            batch_items[m]->export_faces(
+                py_face_sizes ? py_face_sizes + (size_t)batch_face_offsets[m] : NULL, 
+                py_faces ? py_faces + (size_t)batch_face_vert_offsets[m] : NULL);
+        });
+    }
+
+    // ---------------- Only Create edges from faces ----------------
+    // Linear in the number of face sides: every side is bucketed under its lower vertex (counting sort), 
+    // then repeats are dropped within each bucket by remembering which bucket last saw each upper vertex. 
+    static void edges_only(int n_verts, int n_faces, int* faceVerts, int* vertsPerFace, std::vector<int>& edges){
+        std::vector<int> bucket_start(n_verts + 1, 0);
+        int arr_pos = 0;
+        for(int i=0;i<n_faces;i++){            
+            for(int j=0;j<vertsPerFace[i];j++){
+                int origin = faceVerts[arr_pos+j];
+                int endpoint = faceVerts[arr_pos+(j+1)%vertsPerFace[i]];
+                bucket_start[std::min(origin, endpoint) + 1]++;
+            }
+            arr_pos = arr_pos + vertsPerFace[i];
+        }
+        for(int i=0;i<n_verts;i++){
+            bucket_start[i + 1] += bucket_start[i];
+        }
+
+        std::vector<int> bucket(arr_pos);
+        std::vector<int> fill(bucket_start.begin(), bucket_start.end() - 1);
+        arr_pos = 0;
+        for(int i=0;i<n_faces;i++){            
+            for(int j=0;j<vertsPerFace[i];j++){
+                int origin = faceVerts[arr_pos+j];
+                int endpoint = faceVerts[arr_pos+(j+1)%vertsPerFace[i]];
+                bucket[fill[std::min(origin, endpoint)]++] = std::max(origin, endpoint);
+            }
+            arr_pos = arr_pos + vertsPerFace[i];
+        }
+
+        std::vector<int> seen(n_verts, -1);
+        edges.clear();
+        // Two ints per edge, and on a closed manifold mesh every edge shows up on two face sides 
+        edges.reserve(arr_pos);
+        for(int origin=0;origin<n_verts;origin++){
+            for(int k=bucket_start[origin];k<bucket_start[origin + 1];k++){
+                int endpoint = bucket[k];
+                // Degenerate (repeated vertex) sides are not edges 
+                if(endpoint != origin && seen[endpoint] != origin){
+                    seen[endpoint] = origin;
+                    edges.push_back(origin);
+                    edges.push_back(endpoint);
+                }
+            }
+        }
+    }
+
+    // ---------------- Limit Evaluation ----------------
+    // Exact limit positions (and first derivatives) at n_samples (ptex face, u, v) locations, 
+    // from patches instead of a uniformly refined mesh. 
+    // Ptex faces are the faces for quads (triangles with Loop), other faces have one per corner (ordered like their vertices), 
+    // see ptex_faces. u, v are in [0, 1] over the ptex face. 
+    // P, dPdu and dPdv take 3 floats per sample, dPdu/dPdv can be NULL. Samples outside the mesh come out as zeros, 
+    // and so do u, v outside [0, 1] (or NaN), which Far::PatchMap would assert on or map to the wrong patch. 
+    // Returns false if the mesh has no limit surface to speak of (no faces). 
+    int evaluate_limit(int n_verts, int n_faces, float vertices[][3], int* faceVerts, int* vertsPerFace,
+                       int n_samples, int const* sample_faces, float const* sample_uvs, float* P, float* dPdu, float* dPdv) {
+        mesh_input mesh;
+        mesh.n_verts = n_verts;
+        mesh.n_faces = n_faces;
+        mesh.vertices = vertices;
+        mesh.faceVerts = faceVerts;
+        mesh.vertsPerFace = vertsPerFace;
+        mesh.count_faceVerts();
+        if (n_faces <= 0) {
+            return false;
+        }
+
+        // -------- Patches (cached or built) --------
+        int level = limit_entry_level(limit_isolation);
+        uint64_t key = topology_key(mesh, level);
+        std::list<std::shared_ptr<topology_entry>>::iterator it = find_topology(key, mesh, level);
+        std::shared_ptr<topology_entry> entry;
+        cache_hit = it != topology_cache.end();
+        if (cache_hit) {
+            topology_cache.splice(topology_cache.begin(), topology_cache, it);
+            entry = topology_cache.front();
+        } else {
+            entry = build_limit_topology(key, mesh);
+            if (entry->patches == NULL) {
+                return false;
+            }
+            if (cache_size > 0) {
+                topology_cache.push_front(entry);
+                trim_cache();
+            }
+        }
+
+        if(verbose){
+            std::cout << "limit evaluation, isolation " << limit_isolation << ", " << n_samples << " samples, " 
+                      << (cache_hit ? "topology cache hit" : "topology cache miss") << std::endl;
+        }
+
+        // -------- Patch control points --------
+        stencil_view stencils(*entry->stencils);
+
+        limit_control4.resize(4 * (size_t)n_verts);
+        float* padded = &limit_control4[0];
+        limit_points.resize(3 * ((size_t)n_verts + stencils.n_stencils));
+        float* points = &limit_points[0];
+        parallel_chunks(n_verts, [&](int begin, int end) {
+            for (int i = begin; i < end; i++) {
+                padded[4 * i + 0] = points[3 * i + 0] = vertices[i][0];
+                padded[4 * i + 1] = points[3 * i + 1] = vertices[i][1];
+                padded[4 * i + 2] = points[3 * i + 2] = vertices[i][2];
+                padded[4 * i + 3] = 0.0f;
+            }
+        });
+        parallel_chunks(stencils.n_stencils, [&](int begin, int end) {
+            gather_stencils(stencils, padded, points + 3 * (size_t)n_verts, begin, end);
+        });
+
+        // -------- Evaluate the samples --------
+        Far::PatchTable const& patches = *entry->patches;
+        Far::PatchMap const& patch_map = *entry->patch_map;
+        int n_ptex_faces = entry->n_ptex_faces;
+        parallel_chunks(n_samples, [&](int begin, int end) {
+            // Gregory basis end caps have the most control points (20) 
+            float wP[20], wDu[20], wDv[20];
+            for (int i = begin; i < end; i++) {
+                float sum[3][3] = { { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f } };
+                int face = sample_faces[i];
+                float u = sample_uvs[2 * i];
+                float v = sample_uvs[2 * i + 1];
+                // (NaN fails every comparison, so it's out too) 
+                bool inside = face >= 0 && face < n_ptex_faces && u >= 0.0f && u <= 1.0f && v >= 0.0f && v <= 1.0f;
+                Far::PatchMap::Handle const* handle = inside ? patch_map.FindPatch(face, u, v) : NULL;
+                if (handle != NULL) {
+                    patches.EvaluateBasis(*handle, u, v, wP, wDu, wDv);
+                    Far::ConstIndexArray cvs = patches.GetPatchVertices(*handle);
+                    for (int j = 0; j < cvs.size(); j++) {
+                        float const* cv = points + 3 * (size_t)cvs[j];
+                        for (int k = 0; k < 3; k++) {
+                            sum[0][k] += wP[j] * cv[k];
+                            sum[1][k] += wDu[j] * cv[k];
+                            sum[2][k] += wDv[j] * cv[k];
+                        }
+                    }
+                }
+                std::copy(sum[0], sum[0] + 3, P + 3 * (size_t)i);
+                if (dPdu != NULL) {
+                    std::copy(sum[1], sum[1] + 3, dPdu + 3 * (size_t)i);
+                }
+                if (dPdv != NULL) {
+                    std::copy(sum[2], sum[2] + 3, dPdv + 3 * (size_t)i);
+                }
+            }
+        });
+        return true;
+    }
+
+    // First ptex face of every face (n_faces + 1 offsets, the last one is the ptex face count), 
+    // for turning (face, corner) into the face ids evaluate_limit takes. 
+    // Faces of the scheme's regular size (triangles for Loop, quads otherwise) are one ptex face each. 
+    void ptex_faces(int n_faces, int* vertsPerFace, int* offsets) const {
+        int regular = Sdc::SchemeTypeTraits::GetRegularFaceSize(scheme_type());
+        offsets[0] = 0;
+        for (int i = 0; i < n_faces; i++) {
+            offsets[i + 1] = offsets[i] + (vertsPerFace[i] == regular ? 1 : vertsPerFace[i]);
+        }
+    }
+
+    // ---------------- Refine Topology ----------------
+    void refine_topology(int n_verts, int n_faces, float vertices[][3], int* faceVerts, int* vertsPerFace) {
+        mesh_input mesh;
+        mesh.n_verts = n_verts;
+        mesh.n_faces = n_faces;
+        mesh.vertices = vertices;
+        mesh.faceVerts = faceVerts;
+        mesh.vertsPerFace = vertsPerFace;
+        mesh.count_faceVerts();
+        refine_mesh(mesh);
+    }
+
+    // Double precision positions in, interpolated in double (see export_vertices_d). 
+    void refine_topology_d(int n_verts, int n_faces, double const* vertices, int* faceVerts, int* vertsPerFace) {
+        mesh_input mesh;
+        mesh.n_verts = n_verts;
+        mesh.n_faces = n_faces;
+        mesh.vertices_d = vertices;
+        mesh.faceVerts = faceVerts;
+        mesh.vertsPerFace = vertsPerFace;
+        mesh.count_faceVerts();
+        refine_mesh(mesh);
+    }
+
+    // Positions plus extra vertex channels and one face-varying channel, all refined in the same pass. 
+    void refine_primvars(int n_verts, int n_faces, float vertices[][3], int* faceVerts, int* vertsPerFace,
+                         int n_channels, float const* channels, int fvar_width, int n_fvar_values, float const* fvar_values, int* fvar_indices) {
+        mesh_input mesh;
+        mesh.n_verts = n_verts;
+        mesh.n_faces = n_faces;
+        mesh.vertices = vertices;
+        mesh.faceVerts = faceVerts;
+        mesh.vertsPerFace = vertsPerFace;
+        mesh.count_faceVerts();
+        if (channels != NULL && n_channels > 0) {
+            mesh.n_channels = std::min(n_channels, max_primvar_width - 3);
+            mesh.channels = channels;
+        }
+        if (fvar_values != NULL && fvar_indices != NULL && fvar_width > 0 && n_fvar_values > 0) {
+            mesh.fvar_width = std::min(fvar_width, max_primvar_width);
+            mesh.n_fvar_values = n_fvar_values;
+            mesh.fvar_values = fvar_values;
+            mesh.fvar_indices = fvar_indices;
+        }
+        refine_mesh(mesh);
+    }
+
+    // Refines each face to its own level instead of all of them to maxlevel: face_levels has one target level per face, 
+    // clamped to [0, maxlevel], e.g. the faces near the camera or under a brush at maxlevel and 0 everywhere else. 
+    // The result is a single watertight mixed-level mesh, read like any other (export_mesh, export_faces, ...): 
+    // faces bordering finer ones get the finer side's vertices along their edges and come out as n-gons. 
+    // Only the refined faces and the ring around them are refined (see build_selective_topology), 
+    // which is cached like the uniform topologies (keyed on face_levels too) but not written to the disk cache. 
+    // Positions only, there's no stencil path and no update_vertices for these. 
+    void refine_selective(int n_verts, int n_faces, float vertices[][3], int* faceVerts, int* vertsPerFace, int const* face_levels) {
+        SUBDIVIDER_STAT(begin_stats());
+        SUBDIVIDER_TIMER(total_timer, total_ms);
+        reset();
+        mesh_input mesh;
+        mesh.n_verts = n_verts;
+        mesh.n_faces = n_faces;
+        mesh.vertices = vertices;
+        mesh.faceVerts = faceVerts;
+        mesh.vertsPerFace = vertsPerFace;
+        mesh.face_levels = face_levels;
+        mesh.count_faceVerts();
+
+        // -------- Topology (cached or built) --------
+        use_topology(mesh, [this](uint64_t key, mesh_input const& mesh) { return build_selective_topology(key, mesh); });
+
+        if(verbose){
+            std::cout << "selective refinement, maxlevel " << maxlevel << ", " 
+                      << (cache_hit ? "topology cache hit" : "topology cache miss") << std::endl;
+        }
+
+        record_refine_stats(n_verts, n_faces, current->nn_verts, false);
+
+        nn_verts = current->nn_verts;
+        nn_edges = current->nn_edges;
+        nn_faces = current->nn_faces;
+        nn_face_verts = current->faces.size();
+        if (current->pick_offsets.empty() || cancelled()) {
+            // Couldn't be refined (see build_topology), or the job was cancelled 
+            return;
+        }
+
+        // -------- Positions --------
+        SUBDIVIDER_TIMER(interpolate_timer, interpolate_ms);
+        new_vertices.resize(3 * (size_t)nn_verts);
+        if (use_double) {
+            new_vertices_d.resize(3 * (size_t)nn_verts);
+            interpolate_selective<double>(*current, mesh, &new_vertices_d[0]);
+            std::copy(new_vertices_d.begin(), new_vertices_d.end(), new_vertices.begin());
+        } else {
+            interpolate_selective<float>(*current, mesh, &new_vertices[0]);
+        }
+        SUBDIVIDER_STOP(interpolate_timer);
+
+        if (cache_size == 0) {
+            current->release_refinement();
+        }
+        if (verbose) {
+            std::cout << "New Vertices " << nn_verts << ", edges " << nn_edges << ", faces " << nn_faces << std::endl;
+        }
+    }
+
+    // Every level from 0 to maxlevel in one pass (a level of detail chain), for about the cost of refining to maxlevel alone: 
+    // the levels the interpolation goes through anyway are all kept. The results read like any other refinement 
+    // (export_mesh, export_faces, ...) but hold the levels one after the other, with vertex indices local to their level, 
+    // see level_offsets. Level 0 is the incoming mesh. Positions only, no stencil path and no update_vertices. 
+    void refine_levels(int n_verts, int n_faces, float vertices[][3], int* faceVerts, int* vertsPerFace) {
+        SUBDIVIDER_STAT(begin_stats());
+        SUBDIVIDER_TIMER(total_timer, total_ms);
+        reset();
+        mesh_input mesh;
+        mesh.n_verts = n_verts;
+        mesh.n_faces = n_faces;
+        mesh.vertices = vertices;
+        mesh.faceVerts = faceVerts;
+        mesh.vertsPerFace = vertsPerFace;
+        mesh.all_levels = true;
+        mesh.count_faceVerts();
+
+        use_topology(mesh, [this](uint64_t key, mesh_input const& mesh) { return build_levels_topology(key, mesh); });
+
+        if(verbose){
+            std::cout << "levels 0 to " << maxlevel << ", " << (cache_hit ? "topology cache hit" : "topology cache miss") << std::endl;
+        }
+
+        record_refine_stats(n_verts, n_faces, current->nn_verts, false);
+
+        nn_verts = current->nn_verts;
+        nn_edges = current->nn_edges;
+        nn_faces = current->nn_faces;
+        nn_face_verts = current->faces.size();
+        if (current->refiner == NULL || cancelled()) {
+            // Couldn't be refined (see build_topology), or the job was cancelled 
+            return;
+        }
+
+        SUBDIVIDER_TIMER(interpolate_timer, interpolate_ms);
+        new_vertices.resize(3 * (size_t)nn_verts);
+        if (use_double) {
+            new_vertices_d.resize(3 * (size_t)nn_verts);
+            interpolate_levels<double>(*current, mesh, &new_vertices_d[0]);
+            std::copy(new_vertices_d.begin(), new_vertices_d.end(), new_vertices.begin());
+        } else {
+            interpolate_levels<float>(*current, mesh, &new_vertices[0]);
+        }
+        SUBDIVIDER_STOP(interpolate_timer);
+
+        if (cache_size == 0) {
+            current->release_refinement();
+        }
+    }
+
+    // Number of levels in the results (maxlevel + 1 after refine_levels, 0 after any other refinement) 
+    int level_count() const {
+        return current && !current->level_verts.empty() ? (int)current->level_verts.size() - 1 : 0;
+    }
+
+    // level_count() + 1 offsets each into the vertices, edges, faces and face-vertices of the results. NULL skips one. 
+    void level_offsets(int* py_verts, int* py_edges, int* py_faces, int* py_face_verts) const {
+        if (level_count() == 0) {
+            return;
+        }
+        if (py_verts != NULL) {
+            std::copy(current->level_verts.begin(), current->level_verts.end(), py_verts);
+        }
+        if (py_edges != NULL) {
+            std::copy(current->level_edges.begin(), current->level_edges.end(), py_edges);
+        }
+        if (py_faces != NULL) {
+            std::copy(current->level_faces.begin(), current->level_faces.end(), py_faces);
+        }
+        if (py_face_verts != NULL) {
+            std::copy(current->level_face_verts.begin(), current->level_face_verts.end(), py_face_verts);
+        }
+    }
+
+    // nn_verts * 3 doubles. Without double precision these are the float results, widened. 
+    void export_vertices_d(double* py_vertices) {
+        SUBDIVIDER_TIMER(copyout_timer, copyout_ms);
+        if (!new_vertices_d.empty()) {
+            std::copy(new_vertices_d.begin(), new_vertices_d.end(), py_vertices);
+        } else {
+            std::copy(new_vertices.begin(), new_vertices.end(), py_vertices);
+        }
+    }
+
+    // ---------------- Async jobs ----------------
+    // refine_topology on a background thread, so the caller (a UI thread) never waits on a refinement.
+    // The input is copied and the current settings go with it; returns a ticket for poll / wait / cancel / collect.
+    // Jobs run one at a time in submission order, on their own subdivider (and topology cache),
+    // so the handle keeps its results and can still be used directly in the meantime.
+    // With supersede, every older job that hasn't finished yet is cancelled: an edit makes the previous ones stale.
+    int64_t submit(int n_verts, int n_faces, float vertices[][3], int* faceVerts, int* vertsPerFace, int supersede) {
+        std::shared_ptr<refine_job> job = std::make_shared<refine_job>();
+        job->n_verts = n_verts;
+        job->n_faces = n_faces;
+        job->vertices.assign(&vertices[0][0], &vertices[0][0] + 3 * (size_t)n_verts);
+        job->vertsPerFace.assign(vertsPerFace, vertsPerFace + n_faces);
+        size_t n_faceVerts = 0;
+        for (int i = 0; i < n_faces; i++) {
+            n_faceVerts += vertsPerFace[i];
+        }
+        job->faceVerts.assign(faceVerts, faceVerts + n_faceVerts);
+        job->maxlevel = maxlevel;
+        job->scheme = scheme;
+        job->threads = threads;
+        job->cache_size = cache_size;
+        job->use_stencils = use_stencils;
+        job->use_double = use_double;
+        job->reorder = reorder;
+        job->disk_cache_dir = disk_cache_dir;
+
+        if (!async_engine) {
+            async_engine.reset(new subdivider());
+        }
+        if (!async_thread.joinable()) {
+            async_thread = std::thread(&subdivider::async_loop, this);
+        }
+        {
+            std::lock_guard<std::mutex> lock(job_mutex);
+            if (supersede) {
+                for (std::map<int64_t, std::shared_ptr<refine_job>>::iterator it = jobs.begin(); it != jobs.end(); ++it) {
+                    cancel_job(*it->second);
+                }
+            }
+            job->ticket = ++last_ticket;
+            jobs[job->ticket] = job;
+            job_queue.push_back(job);
+        }
+        job_wake.notify_all();
+        return job->ticket;
+    }
+
+    // A job_status
+    int poll(int64_t ticket) {
+        std::lock_guard<std::mutex> lock(job_mutex);
+        std::map<int64_t, std::shared_ptr<refine_job>>::iterator it = jobs.find(ticket);
+        return it != jobs.end() ? it->second->status : job_unknown;
+    }
+
+    // Until the job is no longer pending or running, or timeout_ms (< 0 waits for as long as it takes). Returns its job_status.
+    int wait(int64_t ticket, int timeout_ms) {
+        std::unique_lock<std::mutex> lock(job_mutex);
+        std::map<int64_t, std::shared_ptr<refine_job>>::iterator it = jobs.find(ticket);
+        if (it == jobs.end()) {
+            return job_unknown;
+        }
+        std::shared_ptr<refine_job> job = it->second;
+        auto finished = [&job] { return job->status != job_pending && job->status != job_running; };
+        if (timeout_ms < 0) {
+            job_finished.wait(lock, finished);
+        } else {
+            job_finished.wait_for(lock, std::chrono::milliseconds(timeout_ms), finished);
+        }
+        return job->status;
+    }
+
+    // Returns the job_status afterwards: a running job only reports job_cancelled once it has stopped,
+    // and one that's already done stays done.
+    int cancel(int64_t ticket) {
+        std::lock_guard<std::mutex> lock(job_mutex);
+        std::map<int64_t, std::shared_ptr<refine_job>>::iterator it = jobs.find(ticket);
+        if (it == jobs.end()) {
+            return job_unknown;
+        }
+        cancel_job(*it->second);
+        return it->second->status;
+    }
+
+    // Makes a finished job's results the handle's results (nn_verts, export_mesh, ...) and forgets the ticket.
+    // Returns false (and changes nothing) if it isn't done.
+    // Its topology is shared with the job runner, so the results can't be updated in place (update_vertices):
+    // refine synchronously for that.
+    int collect(int64_t ticket) {
+        std::shared_ptr<refine_job> job;
+        {
+            std::lock_guard<std::mutex> lock(job_mutex);
+            std::map<int64_t, std::shared_ptr<refine_job>>::iterator it = jobs.find(ticket);
+            if (it == jobs.end() || it->second->status != job_done) {
+                return false;
+            }
+            job = it->second;
+            jobs.erase(it);
+        }
+        SUBDIVIDER_STAT(begin_stats());
+        SUBDIVIDER_STAT(stats_last = job->stats);
+        reset();
+        current = job->entry;
+        nn_verts = job->nn_verts;
+        nn_edges = job->nn_edges;
+        nn_faces = job->nn_faces;
+        nn_face_verts = job->nn_face_verts;
+        cache_hit = job->cache_hit;
+        disk_hit = job->disk_hit;
+        new_vertices.swap(job->new_vertices);
+        new_vertices_d.swap(job->new_vertices_d);
+        return true;
+    }
+
+    // Cancels the job if it hasn't finished and forgets the ticket (and any results), e.g. when nobody is going to collect it.
+    void release(int64_t ticket) {
+        std::lock_guard<std::mutex> lock(job_mutex);
+        std::map<int64_t, std::shared_ptr<refine_job>>::iterator it = jobs.find(ticket);
+        if (it != jobs.end()) {
+            cancel_job(*it->second);
+            jobs.erase(it);
+        }
+    }
+
+    // ---------------- Incremental update ----------------
+    // Moves n_changed control vertices of the last refinement (indices into its vertices, 3 floats each in positions) 
+    // and recomputes only the refined vertices whose last level stencils use them (found through the stencils' inverse), 
+    // so an edit costs about its own size rather than the mesh's. Extra channels and face-varying values are left alone. 
+    // The first update of a topology builds the inverse of its stencils. 
+    // Returns the number of refined vertices that changed (see dirty_range / export_dirty), or -1 if there's nothing 
+    // to update: no refinement yet, or one that didn't go through the stencils (set_stencils(0), which keeps no copy 
+    // of the control vertices, unless it was level 0). Out of range indices are skipped. 
+    int update_vertices(int n_changed, int const* indices, float const* positions) {
+        SUBDIVIDER_STAT(begin_stats());
+        SUBDIVIDER_TIMER(total_timer, total_ms);
+        dirty_vertices.clear();
+        if (!updatable || !current || (current->maxlevel > 0 && current->refiner == NULL && current->stencils == NULL && !current->disk_file)) {
+            return -1;
+        }
+        topology_entry& entry = *current;
+        bool double_precision = !new_vertices_d.empty();
+        int n_verts = entry.maxlevel > 0 ? entry.n_verts : nn_verts;
+
+        stencil_view stencils;
+        if (entry.maxlevel > 0) {
+            stencils = vertex_stencils(entry);
+            build_inverse_stencils(entry, stencils);
+        }
+
+        SUBDIVIDER_TIMER(interpolate_timer, interpolate_ms);
+        if (dirty_stamp.size() != (size_t)nn_verts || ++dirty_generation == 0) {
+            dirty_stamp.assign(nn_verts, 0);
+            dirty_generation = 1;
+        }
+
+        // -------- Move the control vertices, collect what they touch --------
+        for (int k = 0; k < n_changed; k++) {
+            int c = indices[k];
+            if (c < 0 || c >= n_verts) {
+                continue;
+            }
+            float const* p = positions + 3 * (size_t)k;
+            if (entry.maxlevel == 0) {
+                // Level 0 results are the control vertices 
+                std::copy(p, p + 3, &new_vertices[3 * (size_t)c]);
+                if (double_precision) {
+                    std::copy(p, p + 3, &new_vertices_d[3 * (size_t)c]);
+                }
+                mark_dirty(c);
+                continue;
+            }
+            if (double_precision) {
+                std::copy(p, p + 3, &control4_d[4 * (size_t)c]);
+            } else {
+                std::copy(p, p + 3, &control4[4 * (size_t)c]);
+            }
+            for (int j = entry.inverse_offsets[c]; j < entry.inverse_offsets[c + 1]; j++) {
+                int i = entry.inverse_stencils[j];
+                mark_dirty(entry.vertex_rank.empty() ? i : entry.vertex_rank[i]);
+            }
+        }
+        std::sort(dirty_vertices.begin(), dirty_vertices.end());
+
+        // -------- Recompute them --------
+        // (result vertex i is stencil order[i] in a reordered topology, see set_reorder) 
+        if (entry.maxlevel > 0 && !dirty_vertices.empty()) {
+            int const* dirty = &dirty_vertices[0];
+            int const* order = entry.vertex_order.empty() ? NULL : &entry.vertex_order[0];
+            if (double_precision) {
+                double const* padded = &control4_d[0];
+                double* positions_d = &new_vertices_d[0];
+                float* positions_f = &new_vertices[0];
+                parallel_chunks(dirty_vertices.size(), [&](int begin, int end) {
+                    for (int k = begin; k < end; k++) {
+                        int i = dirty[k];
+                        gather_stencils(single_stencil(stencils, order ? order[i] : i), padded, positions_d + 3 * (size_t)i, 0, 1);
+                        std::copy(positions_d + 3 * (size_t)i, positions_d + 3 * (size_t)i + 3, positions_f + 3 * (size_t)i);
+                    }
+                });
+            } else {
+                float const* padded = &control4[0];
+                float* positions_f = &new_vertices[0];
+                parallel_chunks(dirty_vertices.size(), [&](int begin, int end) {
+                    for (int k = begin; k < end; k++) {
+                        int i = dirty[k];
+                        gather_stencils(single_stencil(stencils, order ? order[i] : i), padded, positions_f + 3 * (size_t)i, 0, 1);
+                    }
+                });
+            }
+        }
+        SUBDIVIDER_STOP(interpolate_timer);
+
+        SUBDIVIDER_STAT(stats_last.calls = 1);
+        SUBDIVIDER_STAT(stats_last.verts_in = n_changed);
+        SUBDIVIDER_STAT(stats_last.verts_out = dirty_vertices.size());
+        return dirty_vertices.size();
+    }
+
+    // Refined vertices changed by the last update_vertices (sorted), and the range [first, last + 1) they span 
+    // (for partial uploads). Either may be NULL. 
+    void dirty_range(int* py_dirty, int* py_range) {
+        if (py_dirty != NULL) {
+            std::copy(dirty_vertices.begin(), dirty_vertices.end(), py_dirty);
+        }
+        if (py_range != NULL) {
+            py_range[0] = dirty_vertices.empty() ? 0 : dirty_vertices.front();
+            py_range[1] = dirty_vertices.empty() ? 0 : dirty_vertices.back() + 1;
+        }
+    }
+
+    // Writes just the dirty vertices into a full nn_verts * 3 buffer holding the previous results 
+    void export_dirty(float* py_vertices) {
+        SUBDIVIDER_TIMER(copyout_timer, copyout_ms);
+        for (size_t k = 0; k < dirty_vertices.size(); k++) {
+            size_t i = dirty_vertices[k];
+            std::copy(&new_vertices[3 * i], &new_vertices[3 * i] + 3, py_vertices + 3 * i);
+        }
+    }
+
+    // Same in double precision (see export_vertices_d): after a float refinement these are the float results, widened 
+    void export_dirty_d(double* py_vertices) {
+        SUBDIVIDER_TIMER(copyout_timer, copyout_ms);
+        for (size_t k = 0; k < dirty_vertices.size(); k++) {
+            size_t i = dirty_vertices[k];
+            if (!new_vertices_d.empty()) {
+                std::copy(&new_vertices_d[3 * i], &new_vertices_d[3 * i] + 3, py_vertices + 3 * i);
+            } else {
+                std::copy(&new_vertices[3 * i], &new_vertices[3 * i] + 3, py_vertices + 3 * i);
+            }
+        }
+    }
+
+    // ---------------- Result order ----------------
+    // The order of the last refinement's results (see set_reorder): vertex_order[i] is the refiner's vertex that 
+    // became result vertex i (nn_verts of them), face_order[i] the refiner's face that became result face i (nn_faces). 
+    // The identity when the results weren't reordered. NULL skips one. 
+    void export_order(int* py_vertex_order, int* py_face_order) const {
+        bool reordered = current && !current->vertex_order.empty() && (int)current->vertex_order.size() == nn_verts;
+        if (py_vertex_order != NULL) {
+            for (int i = 0; i < nn_verts; i++) {
+                py_vertex_order[i] = reordered ? current->vertex_order[i] : i;
+            }
+        }
+        if (py_face_order != NULL) {
+            for (int i = 0; i < nn_faces; i++) {
+                py_face_order[i] = reordered ? current->face_order[i] : i;
+            }
+        }
+    }
+
+    // ---------------- Outgoing primvars ----------------
+    void primvar_counts(int* n_channels, int* fvar_width, int* nn_fvar_values, int* nn_fvar_indices){
+        *n_channels = this->n_channels;
+        *fvar_width = this->fvar_width;
+        *nn_fvar_values = this->nn_fvar_values;
+        *nn_fvar_indices = (this->fvar_width > 0 && current) ? (int)current->fvar_indices.size() : 0;
+    }
+
+    // Like export_mesh: n_channels * nn_verts, fvar_width * nn_fvar_values and nn_face_verts (laid out like the faces) 
+    // sized buffers, NULL skips one. 
+    void export_primvars(float* channels, float* fvar_values, int* fvar_indices){
+        SUBDIVIDER_TIMER(copyout_timer, copyout_ms);
+        if (channels != NULL) {
+            std::copy(new_channels.begin(), new_channels.end(), channels);
+        }
+        if (fvar_values != NULL) {
+            std::copy(new_fvar_values.begin(), new_fvar_values.end(), fvar_values);
+        }
+        if (fvar_indices != NULL && fvar_width > 0 && current) {
+            std::copy(current->fvar_indices.begin(), current->fvar_indices.end(), fvar_indices);
+        }
+    }
+
+private:
+    // What result_faces and result_face_sizes hand out before the first refinement 
+    static std::vector<int> const& no_results() {
+        static std::vector<int> const empty;
+        return empty;
+    }
+
+    // Level by level, in Real precision (see VertexT). Only two levels are alive at a time (even levels in one buffer, 
+    // odd levels in the other), and the last level is interpolated straight into dst (3 Reals per refined vertex). 
+    template <typename Real>
+    void interpolate_positions(Far::PrimvarRefiner const& primvarRefiner, mesh_input const& mesh, Real* dst) const {
+        Far::TopologyRefiner const& refiner = *current->refiner;
+        std::vector<VertexT<Real, 3> > even(ping_pong_size(refiner, maxlevel, 0, false));
+        std::vector<VertexT<Real, 3> > odd(ping_pong_size(refiner, maxlevel, 1, false));
+        VertexT<Real, 3>* levels[2] = { even.data(), odd.data() };
+
+        for (int i = 0; i < mesh.n_verts; i++) {
+            levels[0][i].SetPosition((Real)mesh.position(i, 0), (Real)mesh.position(i, 1), (Real)mesh.position(i, 2));
+        }
+
+        // -------- Interpolate vertex primvar data --------
+        for (int level = 1; level < maxlevel; ++level) {
+            if (cancelled()) {
+                return;
+            }
+            primvarRefiner.Interpolate(level, levels[(level - 1) & 1], levels[level & 1]);
+        }
+
+        // ---- New Vertices ----
+        if (cancelled()) {
+            return;
+        }
+        position_buffer_t<Real> last(dst);
+        primvarRefiner.Interpolate(maxlevel, levels[(maxlevel - 1) & 1], last);
+    }
+
+    // Level by level like interpolate_positions, every level copied out (3 Reals per vertex) as it's done 
+    template <typename Real>
+    void interpolate_levels(topology_entry const& entry, mesh_input const& mesh, Real* dst) const {
+        Far::TopologyRefiner const& refiner = *entry.refiner;
+        int top = (int)entry.level_verts.size() - 2;
+        for (int i = 0; i < mesh.n_verts; i++) {
+            for (int k = 0; k < 3; k++) {
+                dst[3 * (size_t)i + k] = (Real)mesh.position(i, k);
+            }
+        }
+        if (top == 0) {
+            return;
+        }
+        Far::PrimvarRefiner primvarRefiner(refiner);
+        std::vector<VertexT<Real, 3> > even(ping_pong_size(refiner, top + 1, 0, false));
+        std::vector<VertexT<Real, 3> > odd(ping_pong_size(refiner, top + 1, 1, false));
+        VertexT<Real, 3>* levels[2] = { even.data(), odd.data() };
+        for (int i = 0; i < mesh.n_verts; i++) {
+            levels[0][i].SetPosition((Real)mesh.position(i, 0), (Real)mesh.position(i, 1), (Real)mesh.position(i, 2));
+        }
+        for (int level = 1; level <= top; ++level) {
+            if (cancelled()) {
+                return;
+            }
+            primvarRefiner.Interpolate(level, levels[(level - 1) & 1], levels[level & 1]);
+            VertexT<Real, 3> const* refined = levels[level & 1];
+            Real* out = dst + 3 * (size_t)entry.level_verts[level];
+            for (int i = 0; i < entry.level_verts[level + 1] - entry.level_verts[level]; i++) {
+                std::copy(refined[i].GetPosition(), refined[i].GetPosition() + 3, out + 3 * (size_t)i);
+            }
+        }
+    }
+
+    // Control vertices for the level 0 picks, then level by level through the sub mesh's refiner (see build_selective_topology). 
+    template <typename Real>
+    void interpolate_selective(topology_entry const& entry, mesh_input const& mesh, Real* dst) const {
+        int const* offsets = &entry.pick_offsets[0];
+        int const* sources = entry.pick_sources.data();
+        int const* targets = entry.pick_targets.data();
+        for (int k = offsets[0]; k < offsets[1]; k++) {
+            for (int i = 0; i < 3; i++) {
+                dst[3 * (size_t)targets[k] + i] = (Real)mesh.position(sources[k], i);
+            }
+        }
+        if (entry.refiner == NULL) {
+            return;
+        }
+
+        Far::TopologyRefiner const& refiner = *entry.refiner;
+        int top = refiner.GetMaxLevel();
+        Far::PrimvarRefiner primvarRefiner(refiner);
+        std::vector<VertexT<Real, 3> > even(ping_pong_size(refiner, top + 1, 0, false));
+        std::vector<VertexT<Real, 3> > odd(ping_pong_size(refiner, top + 1, 1, false));
+        VertexT<Real, 3>* levels[2] = { even.data(), odd.data() };
+        for (size_t i = 0; i < entry.sub_verts.size(); i++) {
+            int v = entry.sub_verts[i];
+            levels[0][i].SetPosition((Real)mesh.position(v, 0), (Real)mesh.position(v, 1), (Real)mesh.position(v, 2));
+        }
+        for (int level = 1; level <= top; ++level) {
+            if (cancelled()) {
+                return;
+            }
+            primvarRefiner.Interpolate(level, levels[(level - 1) & 1], levels[level & 1]);
+            VertexT<Real, 3> const* refined = levels[level & 1];
+            for (int k = offsets[level]; k < offsets[level + 1]; k++) {
+                Real const* p = refined[sources[k]].GetPosition();
+                std::copy(p, p + 3, dst + 3 * (size_t)targets[k]);
+            }
+        }
+    }
+
+    void refine_mesh(mesh_input const& input) {
+        mesh_input mesh = input;
+        mesh.reorder = reorder != 0;
+        SUBDIVIDER_STAT(begin_stats());
+        SUBDIVIDER_TIMER(total_timer, total_ms);
+        SUBDIVIDER_STAT(int64_t bytes_before = result_bytes());
+        reset();
+
+        int n_verts = mesh.n_verts;
+        int n_faces = mesh.n_faces;
+        float (*vertices)[3] = mesh.vertices;
+        int* faceVerts = mesh.faceVerts;
+        int* vertsPerFace = mesh.vertsPerFace;
+
+        if(verbose){                
+            std::cout << "maxlevel " << maxlevel << std::endl;
+        }
+
+        // -------- Topology (cached or refined) --------
+        uint64_t key = topology_key(mesh, maxlevel);
+        std::list<std::shared_ptr<topology_entry>>::iterator it = find_topology(key, mesh, maxlevel);
+        cache_hit = it != topology_cache.end();
+        disk_hit = false;
+        if (cache_hit) {
+            // Move to the front (most recently used)
+            topology_cache.splice(topology_cache.begin(), topology_cache, it);
+            current = topology_cache.front();
+        } else {
+            current = disk_cache_dir.empty() ? NULL : load_topology(key, mesh);
+            disk_hit = current != NULL;
+            if (!disk_hit) {
+                current = build_topology(key, mesh);
+                if (!disk_cache_dir.empty()) {
+                    save_topology(*current, mesh);
+                }
+            }
+            if (mesh.reorder) {
+                // After save_topology, the disk cache holds OpenSubdiv's order (the one its stencils are in) 
+                reorder_topology(*current);
+            }
+            if (cache_size > 0) {
+                topology_cache.push_front(current);
+                trim_cache();
+            }
+        }
+
+        if (cancelled()) {
+            // The topology is complete (and cached), only the interpolation is skipped 
+            return;
+        }
+
+        if(verbose){
+            std::cout << (cache_hit ? "topology cache hit" : disk_hit ? "topology disk cache hit" : "topology cache miss") << std::endl;
+        }
+
+        record_refine_stats(n_verts, n_faces, maxlevel == 0 ? n_verts : current->nn_verts, disk_hit);
+
+        nn_edges = current->nn_edges;
+        nn_faces = current->nn_faces;
+        nn_face_verts = current->faces.size();
+        n_channels = mesh.n_channels;
+        fvar_width = mesh.n_fvar_values > 0 ? mesh.fvar_width : 0;
+        nn_fvar_values = fvar_width > 0 ? current->nn_fvar_values : 0;
+
+        if(maxlevel == 0){
+            // Vertices (and primvars) pass straight through 
+            nn_verts = n_verts;
+            if (mesh.vertices_d != NULL) {
+                new_vertices_d.assign(mesh.vertices_d, mesh.vertices_d + 3 * (size_t)n_verts);
+                new_vertices.assign(new_vertices_d.begin(), new_vertices_d.end());
+            } else {
+                new_vertices.assign(&vertices[0][0], &vertices[0][0] + 3 * (size_t)n_verts);
+            }
+            if (n_channels > 0) {
+                new_channels.assign(mesh.channels, mesh.channels + n_channels * (size_t)n_verts);
+            }
+            if (fvar_width > 0) {
+                new_fvar_values.assign(mesh.fvar_values, mesh.fvar_values + fvar_width * (size_t)nn_fvar_values);
+            }
+            updatable = true;
+            if(verbose){
+                std::cout << "New Vertices " << n_verts << std::endl;
+                for(int i=0;i<n_verts;i++){
+                    printf("v %f %f %f\n", new_vertices[3 * i], new_vertices[3 * i + 1], new_vertices[3 * i + 2]);
+                }
+                for(int i = 0; i < nn_edges; i++) {
+                    printf("e %d %d\n", current->edges[2 * i], current->edges[2 * i + 1]);
+                }
+                int arr_pos = 0;
+                for(int i=0;i<n_faces;i++){
+                    std::cout << "f ";
+                    for(int j=0;j<vertsPerFace[i];j++){
+                        // Legacy OBJ vert inds start at 1 (see end of this function)
+                        std::cout << faceVerts[arr_pos+j]+1 << " ";
+                    }
+                    arr_pos = arr_pos + vertsPerFace[i];
+                    std::cout << std::endl;
+                }
+                return;
+            }
+            return;
+        }        
+
+        Far::TopologyRefiner* refiner = current->refiner;
+        nn_verts = current->nn_verts;
+        if (refiner == NULL && !current->disk_file) {
+            // Couldn't be refined (see build_topology) 
+            n_channels = fvar_width = nn_fvar_values = 0;
+            return;
+        }
+        // Positions and extra channels travel together as one interleaved primvar. 
+        // In double precision the positions get a pass of their own and only the channels are interleaved. 
+        bool double_precision = use_double || mesh.vertices_d != NULL;
+        int position_width = double_precision ? 0 : 3;
+        int width = position_width + n_channels;
+
+        // Stencil tables are built (once per topology) before the interpolation is timed. 
+        // Topologies from the disk cache have no refiner, only their stencils. 
+        bool stencil_path = use_stencils || current->disk_file;
+        stencil_view vertex_table = stencil_path ? vertex_stencils(*current) : stencil_view();
+        stencil_view fvar_table = (stencil_path && fvar_width > 0) ? fvar_stencils(*current) : stencil_view();
+
+        SUBDIVIDER_TIMER(interpolate_timer, interpolate_ms);
+
+        new_vertices.resize(3 * (size_t)nn_verts);
+        new_vertices_d.resize(double_precision ? 3 * (size_t)nn_verts : 0);
+        new_channels.resize(n_channels * (size_t)nn_verts);
+        new_fvar_values.resize(fvar_width * (size_t)nn_fvar_values);
+
+        // Interleaved [x, y, z, channels...] (or just [channels...]) control vertices 
+        if (n_channels > 0) {
+            control_interleaved.resize(width * (size_t)n_verts);
+            float* control = control_interleaved.data();
+            float const* channels = mesh.channels;
+            int nc = n_channels;
+            int pw = position_width;
+            parallel_chunks(n_verts, [&](int begin, int end) {
+                for (int i = begin; i < end; i++) {
+                    if (pw > 0) {
+                        std::copy(vertices[i], vertices[i] + pw, control + width * (size_t)i);
+                    }
+                    std::copy(channels + nc * (size_t)i, channels + nc * (size_t)(i + 1), control + width * (size_t)i + pw);
+                }
+            });
+        }
+
+        if (stencil_path) {
+            // Padded control positions, for the stencils and kept for update_vertices 
+            // (the level by level path doesn't need them, so it doesn't pay for them either) 
+            pad_control_positions(mesh, double_precision);
+
+            // -------- Apply last level stencils --------
+            stencil_view const& stencils = vertex_table;
+
+            float* positions = new_vertices.data();
+            if (double_precision) {
+                double const* padded = control4_d.data();
+                double* positions_d = new_vertices_d.data();
+                parallel_chunks(nn_verts, [&](int begin, int end) {
+                    gather_stencils(stencils, padded, positions_d, begin, end);
+                });
+            } else if (n_channels == 0) {
+                float const* padded = control4.data();
+                parallel_chunks(nn_verts, [&](int begin, int end) {
+                    gather_stencils(stencils, padded, positions, begin, end);
+                });
+            }
+            if (n_channels > 0) {
+                float const* control = control_interleaved.data();
+                float* channels = new_channels.data();
+                int pw = position_width;
+                parallel_chunks(nn_verts, [&](int begin, int end) {
+                    gather_stencils_interleaved(stencils, control, width, pw, positions, channels, begin, end);
+                });
+            }
+
+            if (fvar_width > 0) {
+                stencil_view const& fvar_stencils = fvar_table;
+                float const* control = mesh.fvar_values;
+                float* fvalues = new_fvar_values.data();
+                int fw = fvar_width;
+                parallel_chunks(nn_fvar_values, [&](int begin, int end) {
+                    gather_stencils_interleaved(fvar_stencils, control, fw, fw, fvalues, NULL, begin, end);
+                });
+            }
+        } else {
+            // Only two levels are alive at a time: even levels live in one buffer, odd levels in the other, 
+            // and the last level is interpolated straight into the results. 
+            Far::PrimvarRefiner primvarRefiner(*refiner);
+
+            if (double_precision) {
+                // -------- Vertices (double) --------
+                interpolate_positions<double>(primvarRefiner, mesh, new_vertices_d.data());
+            } else if (n_channels == 0) {
+                // -------- Vertices --------
+                interpolate_positions<float>(primvarRefiner, mesh, new_vertices.data());
+            }
+            if (n_channels > 0) {
+                // -------- Vertices + channels (just channels in double precision) --------
+                std::vector<float> even(width * (size_t)ping_pong_size(*refiner, maxlevel, 0, false));
+                std::vector<float> odd(width * (size_t)ping_pong_size(*refiner, maxlevel, 1, false));
+                primvar_buffer levels[2] = { primvar_buffer(even.data(), width), primvar_buffer(odd.data(), width) };
+                std::copy(control_interleaved.begin(), control_interleaved.end(), even.begin());
+
+                for (int level = 1; level < maxlevel && !cancelled(); ++level) {
+                    primvarRefiner.Interpolate(level, levels[(level - 1) & 1], levels[level & 1]);
+                }
+
+                // ---- Split the last level into positions and channels on the way out ----
+                if (position_width > 0 && !cancelled()) {
+                    split_buffer last(new_vertices.data(), new_channels.data(), n_channels);
+                    primvarRefiner.Interpolate(maxlevel, levels[(maxlevel - 1) & 1], last);
+                } else if (!cancelled()) {
+                    primvar_buffer last(new_channels.data(), n_channels);
+                    primvarRefiner.Interpolate(maxlevel, levels[(maxlevel - 1) & 1], last);
+                }
+            }
+
+            if (fvar_width > 0) {
+                // -------- Face-varying values --------
+                std::vector<float> even(fvar_width * (size_t)ping_pong_size(*refiner, maxlevel, 0, true));
+                std::vector<float> odd(fvar_width * (size_t)ping_pong_size(*refiner, maxlevel, 1, true));
+                primvar_buffer levels[2] = { primvar_buffer(even.data(), fvar_width), primvar_buffer(odd.data(), fvar_width) };
+                std::copy(mesh.fvar_values, mesh.fvar_values + fvar_width * (size_t)mesh.n_fvar_values, even.begin());
+
+                for (int level = 1; level < maxlevel && !cancelled(); ++level) {
+                    primvarRefiner.InterpolateFaceVarying(level, levels[(level - 1) & 1], levels[level & 1], 0);
+                }
+                if (!cancelled()) {
+                    primvar_buffer last(new_fvar_values.data(), fvar_width);
+                    primvarRefiner.InterpolateFaceVarying(maxlevel, levels[(maxlevel - 1) & 1], last, 0);
+                }
+            }
+        }
+
+        if (!current->vertex_order.empty() && !cancelled()) {
+            // -------- Into the cache-friendly order (see set_reorder) --------
+            if (double_precision) {
+                permute_vertices(current->vertex_order, 3, new_vertices_d);
+            } else {
+                permute_vertices(current->vertex_order, 3, new_vertices);
+            }
+            permute_vertices(current->vertex_order, n_channels, new_channels);
+        }
+
+        if (double_precision) {
+            // The float results (export_mesh, ...) are rounded from the double ones 
+            double const* src = new_vertices_d.data();
+            float* dst = new_vertices.data();
+            parallel_chunks(nn_verts, [&](int begin, int end) {
+                std::copy(src + 3 * (size_t)begin, src + 3 * (size_t)end, dst + 3 * (size_t)begin);
+            });
+        }
+
+        // A cancelled job (see submit) stops between levels / chunks, with half done results 
+        if (cancelled()) {
+            reset();
+        } else {
+            updatable = stencil_path;
+        }
+
+        SUBDIVIDER_STOP(interpolate_timer);
+        SUBDIVIDER_STAT(stats_last.bytes_allocated += std::max<int64_t>(result_bytes() - bytes_before, 0));
+
+        if (cache_size == 0) {
+            // Nobody is going to reuse this topology 
+            current->release_refinement();
+        }
+
+        if (verbose) {
+            std::cout << "Stages (ms): descriptor " << stats_last.descriptor_ms << ", refine " << stats_last.refine_ms 
+                      << ", extract " << stats_last.extract_ms << ", stencils " << stats_last.stencil_ms 
+                      << ", interpolate " << stats_last.interpolate_ms << std::endl;
+            std::cout << "New Vertices " << nn_verts << std::endl;
+
+            // This outputs "legacy" obj format (at least, as Blender calls it)
+            // I don't know what the modern format is supposed to look like, 
+            // but with this version, vertex indices start at 1, NOT 0. 
+            // NOTE also that Blender applies the Z-up, Y-forward convention,
+            // so remember to set that when importing the obj. 
+            // Otherwise, it comes out rotated.             
+            for (int i = 0; i < nn_verts; i++) {
+                printf("v %f %f %f\n", new_vertices[3 * i],new_vertices[3 * i + 1],new_vertices[3 * i + 2]);
+            }
+            if (fvar_width >= 2) {
+                for (int i = 0; i < nn_fvar_values; i++) {
+                    printf("vt %f %f\n", new_fvar_values[fvar_width * i], new_fvar_values[fvar_width * i + 1]);
+                }
+            }
+            for (int i = 0; i < nn_edges; i++) {
+                printf("e %d %d\n", current->edges[2 * i], current->edges[2 * i + 1]);
+            }
+            int arr_pos = 0;
+            for (int i = 0; i < nn_faces; i++) {
+                std::cout << "f ";
+                for (int j = 0; j < current->face_sizes[i]; j++) {
+                    std::cout << current->faces[arr_pos + j] + 1 << " ";
+                }
+                arr_pos += current->face_sizes[i];
+                std::cout << std::endl;
+            }
+        }
+    }
+};
+
+// Other targets (the python extension module, ...) build on top of this file and bring their own entry point 
+#ifndef SUBDIVIDER_NO_MAIN
+//---------------- OBJ files ----------------
+// Reading and writing for the executable (see main), so whole asset directories can be subdivided without python. 
+struct obj_mesh {
+    // Flat x, y, z 
+    std::vector<float> vertices;
+    std::vector<int> faceVerts;
+    std::vector<int> vertsPerFace;
+};
+
+// Small hand rolled number parsing: the mapped file isn't null terminated (so no strtof), 
+// and this never allocates or looks at the locale. 
+static inline bool obj_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static char const* obj_skip_blanks(char const* p, char const* end) {
+    while (p < end && obj_blank(*p)) {
+        p++;
+    }
+    return p;
+}
+
+static char const* obj_parse_float(char const* p, char const* end, float& value) {
+    static const double powers[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 
+                                     1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18 };
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        p++;
+    }
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    char const* start = p;
+    for (; p < end && *p >= '0' && *p <= '9'; p++) {
+        if (digits < 18) {
+            mantissa = 10 * mantissa + (*p - '0');
+            digits += mantissa > 0;
+        } else {
+            exponent++;
+        }
+    }
+    if (p < end && *p == '.') {
+        p++;
+        for (; p < end && *p >= '0' && *p <= '9'; p++) {
+            if (digits < 18) {
+                mantissa = 10 * mantissa + (*p - '0');
+                digits += mantissa > 0;
+                exponent--;
+            }
+        }
+    }
+    if (p == start) {
+        return NULL;
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        char const* q = p + 1;
+        bool negative_exponent = false;
+        if (q < end && (*q == '-' || *q == '+')) {
+            negative_exponent = *q == '-';
+            q++;
+        }
+        int e = 0;
+        char const* exponent_start = q;
+        for (; q < end && *q >= '0' && *q <= '9'; q++) {
+            e = std::min(10 * e + (*q - '0'), 1000);
+        }
+        if (q > exponent_start) {
+            exponent += negative_exponent ? -e : e;
+            p = q;
+        }
+    }
+    double result = (double)mantissa;
+    while (exponent > 18) {
+        result *= 1e18;
+        exponent -= 18;
+    }
+    while (exponent < -18) {
+        result /= 1e18;
+        exponent += 18;
+    }
+    result = exponent >= 0 ? result * powers[exponent] : result / powers[-exponent];
+    value = (float)(negative ? -result : result);
+    return p;
+}
+
+static char const* obj_parse_int(char const* p, char const* end, int& value) {
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        p++;
+    }
+    char const* start = p;
+    int64_t result = 0;
+    for (; p < end && *p >= '0' && *p <= '9'; p++) {
+        result = std::min<int64_t>(10 * result + (*p - '0'), 0x7fffffff);
+    }
+    if (p == start) {
+        return NULL;
+    }
+    value = (int)(negative ? -result : result);
+    return p;
+}
+
+// Positions (v) and faces (f) of an OBJ file, everything else (vt, vn, l, e, g, usemtl, ...) is skipped. 
+// Face corners may be v, v/vt, v//vn or v/vt/vn, only v is kept; negative indices count back from the last vertex. 
+// One counting pass first (memchr over the lines), so the arrays are allocated exactly once. 
+static bool read_obj(char const* path, obj_mesh& mesh, std::string& error) {
+    mapped_file file(path);
+    if (!file.ok()) {
+        error = std::string("can't read ") + path;
+        return false;
+    }
+    char const* end = file.end;
+
+    size_t n_vertices = 0, n_faces = 0, n_corners = 0;
+    for (char const* line = file.begin; line < end; ) {
+        char const* eol = (char const*)memchr(line, '\n', end - line);
+        eol = eol ? eol : end;
+        char const* p = obj_skip_blanks(line, eol);
+        if (eol - p > 1 && p[0] == 'v' && obj_blank(p[1])) {
+            n_vertices++;
+        } else if (eol - p > 1 && p[0] == 'f' && obj_blank(p[1])) {
+            n_faces++;
+            // Upper bound, one corner per blank 
+            for (char const* q = p + 1; q < eol; q++) {
+                n_corners += *q == ' ' || *q == '\t';
+            }
+        }
+        line = eol + 1;
+    }
+    mesh.vertices.clear();
+    mesh.faceVerts.clear();
+    mesh.vertsPerFace.clear();
+    mesh.vertices.reserve(3 * n_vertices);
+    mesh.vertsPerFace.reserve(n_faces);
+    mesh.faceVerts.reserve(n_corners);
+
+    int line_number = 0;
+    for (char const* line = file.begin; line < end; ) {
+        char const* eol = (char const*)memchr(line, '\n', end - line);
+        eol = eol ? eol : end;
+        line_number++;
+        char const* p = obj_skip_blanks(line, eol);
+        if (eol - p > 1 && p[0] == 'v' && obj_blank(p[1])) {
+            p++;
+            for (int k = 0; k < 3; k++) {
+                float value = 0.0f;
+                p = obj_parse_float(obj_skip_blanks(p, eol), eol, value);
+                if (p == NULL) {
+                    error = "bad vertex on line " + std::to_string(line_number);
+                    return false;
+                }
+                mesh.vertices.push_back(value);
+            }
+        } else if (eol - p > 1 && p[0] == 'f' && obj_blank(p[1])) {
+            p = obj_skip_blanks(p + 1, eol);
+            int corners = 0;
+            while (p < eol && *p != '#') {
+                int index = 0;
+                p = obj_parse_int(p, eol, index);
+                if (p == NULL || index == 0) {
+                    error = "bad face on line " + std::to_string(line_number);
+                    return false;
+                }
+                int n_read = mesh.vertices.size() / 3;
+                index = index > 0 ? index - 1 : n_read + index;
+                if (index < 0 || index >= n_read) {
+                    error = "face index out of range on line " + std::to_string(line_number);
+                    return false;
+                }
+                mesh.faceVerts.push_back(index);
+                corners++;
+                // Skip /vt/vn 
+                while (p < eol && !obj_blank(*p)) {
+                    p++;
+                }
+                p = obj_skip_blanks(p, eol);
+            }
+            if (corners < 3) {
+                error = "face with less than 3 corners on line " + std::to_string(line_number);
+                return false;
+            }
+            mesh.vertsPerFace.push_back(corners);
+        }
+        line = eol + 1;
+    }
+    return true;
+}
+
+// Buffered streaming writer, formats numbers itself (no printf per value) and writes in large blocks. 
+class obj_writer {
+public:
+    explicit obj_writer(FILE* file) : file(file), used(0), failed(false) { }
+    ~obj_writer() { flush(); }
+
+    void text(char const* s) {
+        while (*s) {
+            put(*s++);
+        }
+    }
+
+    // Fixed point with 6 decimals, like printf's %f 
+    void number(float value) {
+        double v = value;
+        if (!(v > -9e12 && v < 9e12)) {
+            char tmp[64];
+            int n = snprintf(tmp, sizeof(tmp), "%f", v);
+            reserve(n);
+            memcpy(buffer + used, tmp, n);
+            used += n;
+            return;
+        }
+        reserve(32);
+        bool negative = v < 0;
+        int64_t fixed = (int64_t)((negative ? -v : v) * 1e6 + 0.5);
+        if (negative && fixed > 0) {
+            buffer[used++] = '-';
+        }
+        write_digits(fixed / 1000000, 1);
+        buffer[used++] = '.';
+        write_digits(fixed % 1000000, 6);
+    }
+
+    void number(int value) {
+        reserve(16);
+        if (value < 0) {
+            buffer[used++] = '-';
+            write_digits(-(int64_t)value, 1);
+        } else {
+            write_digits(value, 1);
+        }
+    }
+
+    void put(char c) {
+        reserve(1);
+        buffer[used++] = c;
+    }
+
+    bool flush() {
+        if (used > 0 && !failed) {
+            failed = fwrite(buffer, 1, used, file) != used;
+        }
+        used = 0;
+        return !failed;
+    }
+
+private:
+    void reserve(size_t n) {
+        if (used + n > sizeof(buffer)) {
+            flush();
+        }
+    }
+
+    // At least min_digits digits (zero padded) 
+    void write_digits(int64_t value, int min_digits) {
+        char tmp[24];
+        int n = 0;
+        do {
+            tmp[n++] = '0' + (char)(value % 10);
+            value /= 10;
+        } while (value > 0 || n < min_digits);
+        while (n > 0) {
+            buffer[used++] = tmp[--n];
+        }
+    }
+
+    FILE* file;
+    char buffer[1 << 20];
+    size_t used;
+    bool failed;
+};
+
+// Refined mesh as OBJ (vertex indices start at 1), to path, or to stdout if path is NULL or "-" 
+static bool write_obj(char const* path, subdivider const& result) {
+    bool to_stdout = path == NULL || strcmp(path, "-") == 0;
+    FILE* file = to_stdout ? stdout : fopen(path, "wb");
+    if (file == NULL) {
+        return false;
+    }
+    bool ok;
+    {
+        std::unique_ptr<obj_writer> writer(new obj_writer(file));
+        float const* v = result.new_vertices.empty() ? NULL : &result.new_vertices[0];
+        for (int i = 0; i < result.nn_verts; i++) {
+            writer->text("v ");
+            writer->number(v[3 * i]);
+            writer->put(' ');
+            writer->number(v[3 * i + 1]);
+            writer->put(' ');
+            writer->number(v[3 * i + 2]);
+            writer->put('\n');
+        }
+        std::vector<int> const& sizes = result.result_face_sizes();
+        std::vector<int> const& faces = result.result_faces();
+        size_t arr_pos = 0;
+        for (size_t i = 0; i < sizes.size(); i++) {
+            writer->put('f');
+            for (int j = 0; j < sizes[i]; j++) {
+                writer->put(' ');
+                writer->number(faces[arr_pos + j] + 1);
+            }
+            arr_pos += sizes[i];
+            writer->put('\n');
+        }
+        ok = writer->flush();
+    }
+    if (!to_stdout) {
+        ok = fclose(file) == 0 && ok;
+    } else {
+        fflush(stdout);
+    }
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    // Example usage: ./ctypes_OpenSubdiv_executable -l 3 -v
+    //                ./ctypes_OpenSubdiv_executable -l 2 -i in.obj -o out.obj [-i in2.obj -o out2.obj ...]
+    // Every -i is paired with the -o that follows it (no -o, or "-o -", writes to stdout). 
+    // Without -i the built-in test mesh is subdivided. 
+    // Defaults 
+    int subdivision_level = 0; 
+    int verbose = false; 
+    std::vector<char const*> inputs;
+    std::vector<char const*> outputs;
+
+    for(int i = 0; i < argc; i++){        
+        std::map<std::string,int> arg_map; 
+        arg_map.insert(std::pair<std::string,int>("-l",1));
+        arg_map.insert(std::pair<std::string,int>("-v",2));
+        arg_map.insert(std::pair<std::string,int>("-i",3));
+        arg_map.insert(std::pair<std::string,int>("-o",4));
+
+        bool has_value = i + 1 < argc;
+        switch(arg_map[argv[i]]) {
+            case 1:                                          
+                // subdivision_level = std::stoi(argv[i+1]); // Windows doesn't like stoi *shrugs*
+                if (has_value) {
+                    subdivision_level = std::atoi(argv[i+1]);
+                    i++;
+                }
+                break;
+            case 2: 
+                verbose = true; 
+                break;
+            case 3:
+                if (has_value) {
+                    inputs.push_back(argv[i+1]);
+                    outputs.push_back(NULL);
+                    i++;
+                }
+                break;
+            case 4:
+                if (has_value && !outputs.empty()) {
+                    outputs.back() = argv[i+1];
+                    i++;
+                } else if (has_value) {
+                    std::cerr << "-o " << argv[i+1] << " needs an -i before it" << std::endl;
+                    return 1;
+                }
+                break;
+        }
+    }
+
+    if (!inputs.empty()) {
+        // One subdivider for all the files, so assets sharing a topology reuse the cached refinement 
+        subdivider subdivider_instance;
+        subdivider_instance.settings(subdivision_level, verbose);
+        obj_mesh mesh;
+        int failures = 0;
+        for (size_t f = 0; f < inputs.size(); f++) {
+            std::string error;
+            if (!read_obj(inputs[f], mesh, error)) {
+                std::cerr << inputs[f] << ": " << error << std::endl;
+                failures++;
+                continue;
+            }
+            int n_verts = mesh.vertices.size() / 3;
+            int n_faces = mesh.vertsPerFace.size();
+            subdivider_instance.refine_topology(n_verts, n_faces, 
+                n_verts > 0 ? (float (*)[3])&mesh.vertices[0] : NULL, 
+                mesh.faceVerts.empty() ? NULL : &mesh.faceVerts[0], 
+                n_faces > 0 ? &mesh.vertsPerFace[0] : NULL);
+            if (!write_obj(outputs[f], subdivider_instance)) {
+                std::cerr << (outputs[f] ? outputs[f] : "stdout") << ": can't write" << std::endl;
+                failures++;
+            }
+        }
+        return failures > 0 ? 1 : 0;
+    }
+
+    // Cube geometry from catmark_cube.h
+    // static float g_verts[8][3] = { { -0.5f, -0.5f,  0.5f },
+    //                             {  0.5f, -0.5f,  0.5f },
+    //                             { -0.5f,  0.5f,  0.5f },
+    //                             {  0.5f,  0.5f,  0.5f },
+    //                             { -0.5f,  0.5f, -0.5f },
+    //                             {  0.5f,  0.5f, -0.5f },
+    //                             { -0.5f, -0.5f, -0.5f },
+    //                             {  0.5f, -0.5f, -0.5f } };
+
+    // static int g_nverts = 8, g_nfaces = 6;
+
+    // static int g_vertsperface[6] = { 4, 4, 4, 4, 4, 4 };
+
+    // static int g_vertIndices[24] = { 0, 1, 3, 2,
+    //                                 2, 3, 5, 4,
+    //                                 4, 5, 7, 6,
+    //                                 6, 7, 1, 0,
+    //                                 1, 7, 5, 3,
+    //                                 6, 0, 2, 4 };
+
+    // Triangle array (for testing non-quads)
+    // static float g_verts[10][3]  = { {-0.75, -1.7320507764816284, 0.0},
+    //                                 {-2.25, -0.8660253882408142, 0.0},
+    //                                 {-2.25, 0.8660253882408142, 0.0},
+    //                                 {0.75, 0.8660253882408142, 0.0},
+    //                                 {-0.75, -1.1102230246251565e-16, 0.0},
+    //                                 {-0.75, 1.7320507764816284, 0.0},
+    //                                 {2.25, -1.7320507764816284, 0.0},
+    //                                 {0.75, -0.8660253882408142, 0.0},
+    //                                 {2.25, 1.7320507764816284, 0.0},
+    //                                 {2.25, 1.1102230246251565e-16, 0.0} };
+
+    // static int g_nverts = 10, g_nfaces = 9;
+
+    // static int g_vertsperface[9] = {3, 3, 3, 3, 3, 3, 3, 3, 3};
+
+    // static int g_vertIndices[27] = { 4, 0, 1, 
+    //                                 1, 2, 4, 
+    //                                 5, 4, 2, 
+    //                                 0, 4, 7, 
+    //                                 3, 7, 4, 
+    //                                 4, 5, 3, 
+    //                                 9, 6, 7, 
+    //                                 7, 3, 9, 
+    //                                 8, 9, 3 };
+
+    // Ngons 
+    // static float g_verts[33][3] = { {8.00f, 0.00f, 0.00f},
+    // {5.66f, 5.66f, 0.00f},
+    // {0.00f, 8.00f, 0.00f},
+    // {-5.66f, 5.66f, 0.00f},
+    // {-8.00f, 0.00f, 0.00f},
+    // {-5.66f, -5.66f, 0.00f},
+    // {-0.00f, -8.00f, 0.00f},
+    // {5.66f, -5.66f, 0.00f},
+    // {7.00f, 0.00f, 0.00f},
+    // {4.36f, 5.47f, 0.00f},
+    // {-1.56f, 6.82f, 0.00f},
+    // {-6.31f, 3.04f, 0.00f},
+    // {-6.31f, -3.04f, 0.00f},
+    // {-1.56f, -6.82f, 0.00f},
+    // {4.36f, -5.47f, 0.00f},
+    // {6.00f, 0.00f, 0.00f},
+    // {3.00f, 5.20f, 0.00f},
+    // {-3.00f, 5.20f, 0.00f},
+    // {-6.00f, 0.00f, 0.00f},
+    // {-3.00f, -5.20f, 0.00f},
+    // {3.00f, -5.20f, 0.00f},
+    // {5.00f, 0.00f, 0.00f},
+    // {1.55f, 4.76f, 0.00f},
+    // {-4.05f, 2.94f, 0.00f},
+    // {-4.05f, -2.94f, 0.00f},
+    // {1.55f, -4.76f, 0.00f},
+    // {4.00f, 0.00f, 0.00f},
+    // {0.00f, 4.00f, 0.00f},
+    // {-4.00f, 0.00f, 0.00f},
+    // {-0.00f, -4.00f, 0.00f},
+    // {3.00f, 0.00f, 0.00f},
+    // {-1.50f, 2.60f, 0.00f},
+    // {-1.50f, -2.60f, 0.00f} };
+
+    // static int g_nverts = 33, g_nfaces = 6;
+
+    // static int g_vertsperface[6] = {8, 7, 6, 5, 4, 3};
+
+    // static int g_vertIndices[33] = {
+    // 0, 1, 2, 3, 4, 5, 6, 7,
+    // 8, 9, 10, 11, 12, 13, 14,
+    // 15, 16, 17, 18, 19, 20,
+    // 21, 22, 23, 24, 25,
+    // 26, 27, 28, 29,
+    // 30, 31, 32 };
+
+    // ngons_2
+    static float g_verts[7][3] = { {-1.00f, -1.00f, 0.00f},
+    {1.00f, -1.00f, 0.00f},
+    {-1.00f, 1.00f, 0.00f},
+    {1.00f, 1.00f, 0.00f},
+    {1.73f, 0.16f, 1.75f},
+    {-1.73f, 1.00f, 1.75f},
+    {0.00f, 1.00f, 2.51f} };
+
+    static int g_nverts = 7, g_nfaces = 3;
+
+    static int g_vertsperface[3] = {5, 4, 3};
+
+    static int g_vertIndices[12] = {
+    2, 3, 4, 6, 5,
+    0, 1, 3, 2,
+    4, 3, 1 };
+
+    subdivider subdivider_instance;    
+    subdivider_instance.settings(subdivision_level,verbose);
+    subdivider_instance.print_settings();
+
+    subdivider_instance.refine_topology(g_nverts, g_nfaces, g_verts, g_vertIndices, g_vertsperface);
+
+    return 0;
+}
+#endif
+
+// ---------------- C API ----------------
+// Every call takes a handle from subdivider_create, there is no global state. 
+// Different handles can be used from different threads at the same time 
+// (e.g. one per node/mesh, with the GIL released around the calls); 
+// a single handle must only be used by one thread at a time. 
+// Submitted jobs (subdivider_submit) run on a thread of their handle's own, that doesn't count. 
+extern "C"
+{
+    DLLEXPORT subdivider* subdivider_create() { return new subdivider(); }
+    DLLEXPORT void subdivider_destroy(subdivider* handle) { delete handle; }
+
+    // threads: 0 = one per core, 1 = single threaded (see subdivider::threads)
+    DLLEXPORT void subdivider_settings(subdivider* handle, int maxlevel, int verbose, int threads) { handle->settings(maxlevel,verbose,threads); }
+
+    DLLEXPORT void subdivider_refine_topology(subdivider* handle, int n_verts, int n_faces, float vertices[][3], int* faceVerts, int* vertsPerFace) { handle->refine_topology(n_verts, n_faces, vertices, faceVerts, vertsPerFace); }    
+
+    // Double precision positions (flat x, y, z), results through subdivider_export_vertices_d (or rounded, through the float calls). 
+    // subdivider_precision(handle, 1) also interpolates float input in double. 
+    DLLEXPORT void subdivider_refine_topology_d(subdivider* handle, int n_verts, int n_faces, double* vertices, int* faceVerts, int* vertsPerFace) { handle->refine_topology_d(n_verts, n_faces, vertices, faceVerts, vertsPerFace); }
+    DLLEXPORT void subdivider_precision(subdivider* handle, int use_double) { handle->set_precision(use_double); }
+    DLLEXPORT void subdivider_export_vertices_d(subdivider* handle, double* py_vertices) { handle->export_vertices_d(py_vertices); }
+
+    // Per-face target levels (clamped to the maxlevel setting), one watertight mixed-level mesh out, see subdivider::refine_selective. 
+    DLLEXPORT void subdivider_refine_selective(subdivider* handle, int n_verts, int n_faces, float vertices[][3], int* faceVerts, int* vertsPerFace, int* face_levels) { handle->refine_selective(n_verts, n_faces, vertices, faceVerts, vertsPerFace, face_levels); }
+
+    // Levels 0 to maxlevel in one call, see subdivider::refine_levels. The usual counts and exports cover all of them, 
+    // subdivider_level_offsets has subdivider_level_count + 1 offsets per array (vertices, edges, faces, face-vertices). 
+    DLLEXPORT void subdivider_refine_levels(subdivider* handle, int n_verts, int n_faces, float vertices[][3], int* faceVerts, int* vertsPerFace) { handle->refine_levels(n_verts, n_faces, vertices, faceVerts, vertsPerFace); }
+    DLLEXPORT int subdivider_level_count(subdivider* handle) { return handle->level_count(); }
+    DLLEXPORT void subdivider_level_offsets(subdivider* handle, int* verts, int* edges, int* faces, int* face_verts) { handle->level_offsets(verts, edges, faces, face_verts); }
+
+    // Asynchronous refinement, see subdivider::submit. A ticket goes through 
+    // pending (0) -> running (1) -> done (2) / cancelled (3) / failed (4), -1 once it's collected or released (or unknown). 
+    // subdivider_wait takes a timeout in milliseconds (< 0: no timeout), poll / wait / cancel return the status. 
+    // subdivider_collect makes a done job's results the handle's (then read them as after subdivider_refine_topology). 
+    DLLEXPORT int64_t subdivider_submit(subdivider* handle, int n_verts, int n_faces, float vertices[][3], int* faceVerts, int* vertsPerFace, int supersede) { return handle->submit(n_verts, n_faces, vertices, faceVerts, vertsPerFace, supersede); }
+    DLLEXPORT int subdivider_poll(subdivider* handle, int64_t ticket) { return handle->poll(ticket); }
+    DLLEXPORT int subdivider_wait(subdivider* handle, int64_t ticket, int timeout_ms) { return handle->wait(ticket, timeout_ms); }
+    DLLEXPORT int subdivider_cancel(subdivider* handle, int64_t ticket) { return handle->cancel(ticket); }
+    DLLEXPORT int subdivider_collect(subdivider* handle, int64_t ticket) { return handle->collect(ticket); }
+    DLLEXPORT void subdivider_release(subdivider* handle, int64_t ticket) { handle->release(ticket); }
+
+    // Incremental update of the last refinement, see subdivider::update_vertices. 
+    // Returns the number of changed refined vertices (-1: nothing to update, refine again; updates need subdivider_stencils). 
+    // subdivider_dirty_vertices fills that many sorted indices and/or their [first, last + 1) range (either may be NULL), 
+    // subdivider_export_dirty writes just those vertices into a buffer holding the previous results, 
+    // subdivider_export_dirty_d into a double one (full precision after a double precision refinement). 
+    DLLEXPORT int subdivider_update_vertices(subdivider* handle, int n_changed, int* indices, float* positions) { return handle->update_vertices(n_changed, indices, positions); }
+    DLLEXPORT void subdivider_dirty_vertices(subdivider* handle, int* dirty, int* range) { handle->dirty_range(dirty, range); }
+    DLLEXPORT void subdivider_export_dirty(subdivider* handle, float* py_vertices) { handle->export_dirty(py_vertices); }
+    DLLEXPORT void subdivider_export_dirty_d(subdivider* handle, double* py_vertices) { handle->export_dirty_d(py_vertices); }
+
+    // Extra vertex channels (n_channels floats per vertex) and one face-varying channel (fvar_width floats per value, 
+    // one value index per face-vertex), refined together with the positions. NULL channels / fvar_values skip them. 
+    // The refined face-varying indices come out one per face-vertex, laid out like the faces (see subdivider_export_faces). 
+    DLLEXPORT void subdivider_refine_primvars(subdivider* handle, int n_verts, int n_faces, float vertices[][3], int* faceVerts, int* vertsPerFace,
+                                              int n_channels, float const* channels, int fvar_width, int n_fvar_values, float const* fvar_values, int* fvar_indices) { 
+        handle->refine_primvars(n_verts, n_faces, vertices, faceVerts, vertsPerFace, n_channels, channels, fvar_width, n_fvar_values, fvar_values, fvar_indices); 
+    }
+    DLLEXPORT void subdivider_primvar_counts(subdivider* handle, int* n_channels, int* fvar_width, int* nn_fvar_values, int* nn_fvar_indices) { handle->primvar_counts(n_channels, fvar_width, nn_fvar_values, nn_fvar_indices); }
+    DLLEXPORT void subdivider_export_primvars(subdivider* handle, float* py_channels, float* py_fvar_values, int* py_fvar_indices) { handle->export_primvars(py_channels, py_fvar_values, py_fvar_indices); }
+
+    // Limit surface evaluation at (ptex face, u, v) samples, see subdivider::evaluate_limit. 
+    // sample_uvs holds 2 floats per sample, P/dPdu/dPdv 3 floats per sample (dPdu/dPdv may be NULL). 
+    // A sample with a face id past the ptex faces, or u or v outside [0, 1] (or NaN), gets zeros. 
+    DLLEXPORT void subdivider_limit_isolation(subdivider* handle, int limit_isolation) { handle->set_limit_isolation(limit_isolation); }
+    DLLEXPORT int subdivider_evaluate_limit(subdivider* handle, int n_verts, int n_faces, float vertices[][3], int* faceVerts, int* vertsPerFace,
+                                            int n_samples, int const* sample_faces, float const* sample_uvs, float* P, float* dPdu, float* dPdv) { 
+        return handle->evaluate_limit(n_verts, n_faces, vertices, faceVerts, vertsPerFace, n_samples, sample_faces, sample_uvs, P, dPdu, dPdv); 
+    }
+    DLLEXPORT void subdivider_ptex_faces(subdivider* handle, int n_faces, int* vertsPerFace, int* offsets) { handle->ptex_faces(n_faces, vertsPerFace, offsets); }
+
+    // Topology cache. Entries are keyed on the faces, the vertex count and the settings, 
+    // so they only need to be evicted to release memory (or if the caller knows a topology is gone for good). 
+    DLLEXPORT void subdivider_cache_size(subdivider* handle, int cache_size) { handle->set_cache_size(cache_size); }
+    DLLEXPORT void subdivider_cache_invalidate(subdivider* handle) { handle->invalidate_cache(); }
+    DLLEXPORT int subdivider_cache_evict(subdivider* handle, int n_verts, int n_faces, int* faceVerts, int* vertsPerFace) { return handle->evict_topology(n_verts, n_faces, faceVerts, vertsPerFace); }
+    DLLEXPORT int subdivider_cache_hit(subdivider* handle) { return handle->cache_hit; }
+
+    // Disk cache (see subdivider::set_disk_cache), NULL or "" turns it off. 
+    // subdivider_disk_cache_hit: whether the last refinement's topology was loaded from it. 
+    DLLEXPORT void subdivider_disk_cache(subdivider* handle, char const* directory) { handle->set_disk_cache(directory); }
+    DLLEXPORT int subdivider_disk_cache_hit(subdivider* handle) { return handle->disk_hit; }
+
+    // scheme: 0 = Bilinear, 1 = CatMark (default), 2 = Loop (triangle meshes only) 
+    DLLEXPORT void subdivider_scheme(subdivider* handle, int scheme) { handle->set_scheme(scheme); }
+
+    // Stencil mode, see subdivider::use_stencils
+    DLLEXPORT void subdivider_use_stencils(subdivider* handle, int use_stencils) { handle->set_stencils(use_stencils); }
+
+    // Cache-friendly order of the results, see subdivider::set_reorder. 
+    // subdivider_export_order takes nn_verts and nn_faces sized buffers (NULL skips one). 
+    DLLEXPORT void subdivider_reorder(subdivider* handle, int reorder) { handle->set_reorder(reorder); }
+    DLLEXPORT void subdivider_export_order(subdivider* handle, int* vertex_order, int* face_order) { handle->export_order(vertex_order, face_order); }
+
+    // Instrumentation, see subdivider_stats. Either pointer may be NULL. 
+    // subdivider_stats_enabled is 0 when the library was built with -DSUBDIVIDER_NO_STATS (all counters stay at 0). 
+    DLLEXPORT void subdivider_stats_get(subdivider* handle, subdivider_stats* last, subdivider_stats* total) { handle->get_stats(last, total); }
+    DLLEXPORT void subdivider_stats_reset(subdivider* handle) { handle->reset_stats(); }
+    DLLEXPORT int subdivider_stats_enabled() {
+#ifndef SUBDIVIDER_NO_STATS
+        return 1;
+#else
+        return 0;
+#endif
+    }
+
+    // AVX2 + FMA stencil kernels on (the default) or off, for every subdivider in the process. 
+    // Returns 1 if they're used from now on, 0 if they're off or the CPU / build doesn't have them. 
+    DLLEXPORT int subdivider_use_avx2(int enabled) {
+        avx2_allowed = enabled != 0;
+        return use_avx2() ? 1 : 0;
+    }
+
+    // Many meshes at once, subdivided in parallel (see subdivider::refine_batch). 
+    // subdivider_batch_offsets fills four n_meshes + 1 offset tables (vertices, edges, faces, face-vertices), 
+    // whose last entries are the totals to allocate for subdivider_batch_export (faces in CSR form). 
+    // n_verts, n_faces and n_faceVerts are the lengths of vertices, vertsPerFace and faceVerts. 
+    // Returns 0, or -1 without refining anything if the offsets aren't ascending or run past those lengths. 
+    DLLEXPORT int subdivider_refine_batch(subdivider* handle, int n_meshes, int* vert_offsets, int* face_offsets, int n_verts, int n_faces, int n_faceVerts, 
+                                          float vertices[][3], int* faceVerts, int* vertsPerFace) { 
+        return handle->refine_batch(n_meshes, vert_offsets, face_offsets, n_verts, n_faces, n_faceVerts, vertices, faceVerts, vertsPerFace) ? 0 : -1; 
+    }
+    DLLEXPORT void subdivider_batch_offsets(subdivider* handle, int* vert_offsets, int* edge_offsets, int* face_offsets, int* face_vert_offsets) { handle->return_batch_offsets(vert_offsets, edge_offsets, face_offsets, face_vert_offsets); }
+    DLLEXPORT void subdivider_batch_export(subdivider* handle, float* py_vertices, int* py_edges, int* py_vertsPerFace, int* py_faceVerts) { handle->export_batch(py_vertices, py_edges, py_vertsPerFace, py_faceVerts); }
+
+    DLLEXPORT int subdivider_nn_verts(subdivider* handle) { return handle->nn_verts; }
+    DLLEXPORT int subdivider_nn_edges(subdivider* handle) { return handle->nn_edges; }
+    DLLEXPORT int subdivider_nn_faces(subdivider* handle) { return handle->nn_faces; }
+    DLLEXPORT int subdivider_nn_face_verts(subdivider* handle) { return handle->nn_face_verts; }
+
+    DLLEXPORT void subdivider_new_vertices(subdivider* handle, float py_new_vertices[][3]) { handle->return_new_vertices(py_new_vertices); }
+    DLLEXPORT void subdivider_new_edges(subdivider* handle, int py_new_edges[][2]) { handle->return_new_edges(py_new_edges); }
+    DLLEXPORT void subdivider_new_faces(subdivider* handle, int py_new_faces[][4]) { handle->return_new_faces(py_new_faces); }
+
+    // All results in one call (see subdivider::export_mesh), or pointers to them for zero-copy views. 
+    DLLEXPORT void subdivider_export(subdivider* handle, float* py_vertices, int* py_edges, int* py_faces) { handle->export_mesh(py_vertices, py_edges, py_faces); }
+    DLLEXPORT void subdivider_buffers(subdivider* handle, float** py_vertices, int** py_edges, int** py_faces, int** py_face_sizes) { handle->result_buffers(py_vertices, py_edges, py_faces, py_face_sizes); }
+
+    // Faces of any size (and at any level) in CSR form: nn_faces sizes and nn_face_verts vertex indices. 
+    DLLEXPORT void subdivider_export_faces(subdivider* handle, int* py_vertsPerFace, int* py_faceVerts) { handle->export_faces(py_vertsPerFace, py_faceVerts); }
+
+    // This technically works but doesn't return anything back to python,
+    // even though I would expect py_new_faces to be passed by reference. 
+    // Confused. 
+    // Separate issue that each row of the matrix can have different length
+    // (each face may have an arbitrary number of verts),
+    // which seems really hard to implement on the ctypes side, if possible at all. 
+    // DLLEXPORT void new_faces(int **py_new_faces) { subdivider_new.return_new_faces(py_new_faces); }
+}
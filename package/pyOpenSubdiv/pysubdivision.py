@@ -1,14 +1,787 @@
 import ctypes
 import numpy as np
+import os
 import sys
+import threading
 import traceback
 
 from pyOpenSubdiv.clib import load_library
 OpenSubdiv_clib = load_library.load_library()
 
+# Native extension module (make extension), used by pysubdivide when it's there. 
+# It takes numpy / array.array / Blender buffers as they are and skips the ctypes layer entirely. 
+try:
+    from pyOpenSubdiv.clib import _pysubdivision
+except ImportError:
+    _pysubdivision = None
+
+################ C API ################
+# argtypes/restype are declared once here rather than on every call. 
+# OpenSubdiv_clib is a ctypes.CDLL, which releases the GIL for the duration of every call, 
+# so separate Subdivider instances really do refine in parallel from separate threads. 
+_float_p = ctypes.POINTER(ctypes.c_float)
+_int_p = ctypes.POINTER(ctypes.c_int)
+_handle = ctypes.c_void_p
+
+def _declare(name,restype,argtypes):
+    # A library built from an older ctypes_subdivider.cpp lacks the newer functions, say so instead of an AttributeError 
+    try:
+        function = getattr(OpenSubdiv_clib,name)
+    except AttributeError:
+        raise ImportError("%s has no %s: the library is out of date, rebuild it (see README)" % (OpenSubdiv_clib._name,name)) from None
+    function.restype = restype
+    function.argtypes = argtypes
+    return function
+
+# Mirrors struct subdivider_stats (field order matters) 
+class SubdividerStats(ctypes.Structure):
+    _fields_ = [
+        ('calls',ctypes.c_int64),
+        ('cache_hits',ctypes.c_int64),
+        ('descriptor_ms',ctypes.c_double),
+        ('refine_ms',ctypes.c_double),
+        ('extract_ms',ctypes.c_double),
+        ('stencil_ms',ctypes.c_double),
+        ('interpolate_ms',ctypes.c_double),
+        ('copyout_ms',ctypes.c_double),
+        ('total_ms',ctypes.c_double),
+        ('verts_in',ctypes.c_int64),
+        ('faces_in',ctypes.c_int64),
+        ('verts_out',ctypes.c_int64),
+        ('edges_out',ctypes.c_int64),
+        ('faces_out',ctypes.c_int64),
+        ('bytes_allocated',ctypes.c_int64),
+        ('disk_hits',ctypes.c_int64),
+    ]
+
+    def as_dict(self):
+        return {name : getattr(self,name) for name, _ in self._fields_}
+
+_declare('subdivider_create',_handle,[])
+_declare('subdivider_destroy',None,[_handle])
+_declare('subdivider_settings',None,[
+    _handle,
+    ctypes.c_int, # maxlevel 
+    ctypes.c_int, # verbose
+    ctypes.c_int # threads
+])
+_declare('subdivider_refine_topology',None,[
+    _handle,
+    ctypes.c_int, # n_verts
+    ctypes.c_int, # n_faces     
+    _float_p, # vertices (n_verts x 3)
+    _int_p, # faceVerts
+    _int_p # vertsPerFace
+])
+_double_p = ctypes.POINTER(ctypes.c_double)
+_declare('subdivider_refine_topology_d',None,[_handle,ctypes.c_int,ctypes.c_int,_double_p,_int_p,_int_p])
+_declare('subdivider_precision',None,[_handle,ctypes.c_int])
+_declare('subdivider_export_vertices_d',None,[_handle,_double_p])
+_declare('subdivider_refine_selective',None,[_handle,ctypes.c_int,ctypes.c_int,_float_p,_int_p,_int_p,_int_p])
+_declare('subdivider_refine_levels',None,[_handle,ctypes.c_int,ctypes.c_int,_float_p,_int_p,_int_p])
+_declare('subdivider_level_count',ctypes.c_int,[_handle])
+_declare('subdivider_level_offsets',None,[_handle,_int_p,_int_p,_int_p,_int_p])
+_declare('subdivider_submit',ctypes.c_int64,[_handle,ctypes.c_int,ctypes.c_int,_float_p,_int_p,_int_p,ctypes.c_int])
+_declare('subdivider_poll',ctypes.c_int,[_handle,ctypes.c_int64])
+_declare('subdivider_wait',ctypes.c_int,[_handle,ctypes.c_int64,ctypes.c_int])
+_declare('subdivider_cancel',ctypes.c_int,[_handle,ctypes.c_int64])
+_declare('subdivider_collect',ctypes.c_int,[_handle,ctypes.c_int64])
+_declare('subdivider_release',None,[_handle,ctypes.c_int64])
+_declare('subdivider_update_vertices',ctypes.c_int,[_handle,ctypes.c_int,_int_p,_float_p])
+_declare('subdivider_dirty_vertices',None,[_handle,_int_p,_int_p])
+_declare('subdivider_export_dirty',None,[_handle,_float_p])
+_declare('subdivider_export_dirty_d',None,[_handle,_double_p])
+_declare('subdivider_refine_primvars',None,[
+    _handle,
+    ctypes.c_int, # n_verts
+    ctypes.c_int, # n_faces     
+    _float_p, # vertices (n_verts x 3)
+    _int_p, # faceVerts
+    _int_p, # vertsPerFace
+    ctypes.c_int, # n_channels
+    _float_p, # channels (n_verts x n_channels)
+    ctypes.c_int, # fvar_width
+    ctypes.c_int, # n_fvar_values
+    _float_p, # fvar_values (n_fvar_values x fvar_width)
+    _int_p # fvar_indices (one per face-vertex, like faceVerts)
+])
+_declare('subdivider_primvar_counts',None,[_handle,_int_p,_int_p,_int_p,_int_p])
+_declare('subdivider_export_primvars',None,[_handle,_float_p,_float_p,_int_p])
+_declare('subdivider_limit_isolation',None,[_handle,ctypes.c_int])
+_declare('subdivider_evaluate_limit',ctypes.c_int,[
+    _handle,
+    ctypes.c_int, # n_verts
+    ctypes.c_int, # n_faces     
+    _float_p, # vertices (n_verts x 3)
+    _int_p, # faceVerts
+    _int_p, # vertsPerFace
+    ctypes.c_int, # n_samples
+    _int_p, # sample_faces (ptex face ids)
+    _float_p, # sample_uvs (n_samples x 2)
+    _float_p, # P (n_samples x 3)
+    _float_p, # dPdu (n_samples x 3, or NULL)
+    _float_p # dPdv (n_samples x 3, or NULL)
+])
+_declare('subdivider_ptex_faces',None,[_handle,ctypes.c_int,_int_p,_int_p])
+_declare('subdivider_scheme',None,[_handle,ctypes.c_int])
+_declare('subdivider_cache_size',None,[_handle,ctypes.c_int])
+_declare('subdivider_cache_invalidate',None,[_handle])
+_declare('subdivider_cache_evict',ctypes.c_int,[_handle,ctypes.c_int,ctypes.c_int,_int_p,_int_p])
+_declare('subdivider_cache_hit',ctypes.c_int,[_handle])
+_declare('subdivider_disk_cache',None,[_handle,ctypes.c_char_p])
+_declare('subdivider_disk_cache_hit',ctypes.c_int,[_handle])
+_declare('subdivider_use_stencils',None,[_handle,ctypes.c_int])
+_declare('subdivider_reorder',None,[_handle,ctypes.c_int])
+_declare('subdivider_export_order',None,[_handle,_int_p,_int_p])
+_declare('subdivider_stats_get',None,[_handle,ctypes.POINTER(SubdividerStats),ctypes.POINTER(SubdividerStats)])
+_declare('subdivider_stats_reset',None,[_handle])
+_declare('subdivider_stats_enabled',ctypes.c_int,[])
+_declare('subdivider_use_avx2',ctypes.c_int,[ctypes.c_int])
+_declare('subdivider_refine_batch',ctypes.c_int,[
+    _handle,
+    ctypes.c_int, # n_meshes
+    _int_p, # vert_offsets (n_meshes + 1)
+    _int_p, # face_offsets (n_meshes + 1)
+    ctypes.c_int, # n_verts (all meshes)
+    ctypes.c_int, # n_faces (all meshes)
+    ctypes.c_int, # n_faceVerts (all meshes)
+    _float_p, # vertices (all meshes)
+    _int_p, # faceVerts (all meshes, local to each mesh)
+    _int_p # vertsPerFace (all meshes)
+])
+_declare('subdivider_batch_offsets',None,[_handle,_int_p,_int_p,_int_p,_int_p])
+_declare('subdivider_batch_export',None,[_handle,_float_p,_int_p,_int_p,_int_p])
+_declare('subdivider_nn_verts',ctypes.c_int,[_handle])
+_declare('subdivider_nn_edges',ctypes.c_int,[_handle])
+_declare('subdivider_nn_faces',ctypes.c_int,[_handle])
+_declare('subdivider_nn_face_verts',ctypes.c_int,[_handle])
+_declare('subdivider_export',None,[_handle,_float_p,_int_p,_int_p])
+_declare('subdivider_buffers',None,[_handle,ctypes.POINTER(_float_p),ctypes.POINTER(_int_p),ctypes.POINTER(_int_p),ctypes.POINTER(_int_p)])
+_declare('subdivider_export_faces',None,[_handle,_int_p,_int_p])
+
+def _as_pointer(array,pointer_type):
+    if(array is None):
+        return None 
+    return array.ctypes.data_as(pointer_type)
+
+def _topology_arrays(faceVerts,vertsPerFace):
+    faceVerts = np.ascontiguousarray(faceVerts,dtype=np.int32).reshape(-1)
+    vertsPerFace = np.ascontiguousarray(vertsPerFace,dtype=np.int32).reshape(-1)
+    return faceVerts, vertsPerFace
+
+def face_lists(vertsPerFace,faceVerts):
+    # CSR faces (sizes + flat vertex indices) to a list of vertex lists, e.g. for Blender's from_pydata. 
+    # All-quad (or all-triangle) output takes a single reshape. 
+    if(len(vertsPerFace) == 0):
+        return []
+    if(np.all(vertsPerFace == vertsPerFace[0])):
+        return faceVerts.reshape(-1,int(vertsPerFace[0])).tolist()
+    return [face.tolist() for face in np.split(faceVerts,np.cumsum(vertsPerFace)[:-1])]
+
+################ Subdivider ################
+# Sdc::SchemeType values 
+SCHEMES = {'bilinear':0,'catmark':1,'loop':2}
+
+# enum job_status 
+JOB_PENDING, JOB_RUNNING, JOB_DONE, JOB_CANCELLED, JOB_FAILED = range(5)
+
+class RefineFuture:
+    """
+    A refinement running in the background (Subdivider.submit), shaped like a concurrent.futures.Future. 
+    done() never blocks, so a UI thread can check on it from a timer. 
+    result() makes it the subdivider's current results (counts, export_mesh, view_results, ...) 
+    and returns the new mesh as numpy arrays. 
+    """
+    def __init__(self,subdivider,ticket):
+        self._subdivider = subdivider
+        self._ticket = ticket
+        self._status = JOB_PENDING
+        self._result = None
+
+    def __del__(self):
+        # Nobody is going to collect it 
+        if(self._result is None and getattr(self._subdivider,'_handle',None)):
+            OpenSubdiv_clib.subdivider_release(self._subdivider._handle,self._ticket)
+
+    def _update(self,status):
+        # Collected or released tickets are unknown (-1) to the library, keep what we last saw 
+        if(status >= 0):
+            self._status = status
+        return self._status
+
+    def status(self):
+        if(self._result is not None):
+            return self._status
+        return self._update(OpenSubdiv_clib.subdivider_poll(self._subdivider._handle,self._ticket))
+
+    def running(self):
+        return self.status() == JOB_RUNNING
+
+    def done(self):
+        return self.status() >= JOB_DONE
+
+    def cancelled(self):
+        return self.status() == JOB_CANCELLED
+
+    def cancel(self):
+        # True if it won't produce a result. A running job stops at its next refinement level / chunk, 
+        # so it may only report cancelled a moment later. 
+        if(self._result is None):
+            self._update(OpenSubdiv_clib.subdivider_cancel(self._subdivider._handle,self._ticket))
+        return self._status in (JOB_PENDING,JOB_RUNNING,JOB_CANCELLED)
+
+    def result(self,timeout=None):
+        import concurrent.futures
+        if(self._result is not None):
+            return self._result
+        timeout_ms = -1 if timeout is None else int(timeout * 1000)
+        status = self._update(OpenSubdiv_clib.subdivider_wait(self._subdivider._handle,self._ticket,timeout_ms))
+        if(status in (JOB_PENDING,JOB_RUNNING)):
+            raise concurrent.futures.TimeoutError()
+        if(status == JOB_CANCELLED):
+            raise concurrent.futures.CancelledError()
+        if(status == JOB_FAILED or not OpenSubdiv_clib.subdivider_collect(self._subdivider._handle,self._ticket)):
+            raise RuntimeError("refinement failed")
+
+        nn_verts, nn_edges, nn_faces = self._subdivider.counts()
+        edges = np.empty((nn_edges,2),dtype=np.int32)
+        self._subdivider.export_mesh(None,edges,None)
+        vertsPerFace, faceVerts = self._subdivider.export_faces()
+        self._result = {
+            'vertices' : self._subdivider.export_vertices(np.float64 if self._subdivider._double else np.float32),
+            'edges' : edges,
+            'vertsPerFace' : vertsPerFace,
+            'faceVerts' : faceVerts
+        }
+        return self._result
+
+class Subdivider:
+    """
+    One native subdivider (a handle from subdivider_create) with its own settings, topology cache and results. 
+    Separate instances can be used from separate threads at the same time, 
+    a single instance must only be used from one thread at a time. 
+    """
+    def __init__(self,subdivision_level=0,verbose=False,threads=0):
+        self._handle = OpenSubdiv_clib.subdivider_create()
+        self._double = False
+        self.settings(subdivision_level,verbose,threads)
+
+    def __del__(self):
+        self.close()
+
+    def close(self):
+        if(getattr(self,'_handle',None)):
+            OpenSubdiv_clib.subdivider_destroy(self._handle)
+            self._handle = None
+
+    def set_scheme(self,scheme):
+        # 'bilinear', 'catmark' (default) or 'loop' (triangle meshes only) 
+        OpenSubdiv_clib.subdivider_scheme(self._handle,SCHEMES[scheme])
+
+    def set_precision(self,precision):
+        # 'float' (default) or 'double'. In double precision the positions go in and are interpolated as float64 
+        # (see export_vertices), for large meshes where float drift shows at level 4 and up. 
+        # Extra channels and face-varying values stay float32. 
+        self._double = precision == 'double'
+        OpenSubdiv_clib.subdivider_precision(self._handle,int(self._double))
+
+    def settings(self,subdivision_level,verbose=False,threads=0):
+        # threads: 0 = one per core, 1 = single threaded. 
+        # Used by refine_batch and by stencil evaluation (use_stencils), whose results don't depend on the thread count. 
+        OpenSubdiv_clib.subdivider_settings(self._handle,subdivision_level,int(verbose),threads)
+
+    def refine(self,vertices,faceVerts,vertsPerFace,channels=None,fvar_values=None,fvar_indices=None):
+        # channels: extra per-vertex data (n_verts x n_channels, e.g. weights or colors), 
+        # fvar_values + fvar_indices: one face-varying channel (e.g. UVs, n_values x width plus one index per face-vertex). 
+        # Both are refined in the same pass as the positions, see export_primvars. 
+        faceVerts, vertsPerFace = _topology_arrays(faceVerts,vertsPerFace)
+        if(self._double and channels is None and fvar_values is None):
+            vertices = np.ascontiguousarray(vertices,dtype=np.float64).reshape(-1,3)
+            OpenSubdiv_clib.subdivider_refine_topology_d(
+                self._handle,
+                len(vertices),
+                len(vertsPerFace),
+                _as_pointer(vertices,_double_p),
+                _as_pointer(faceVerts,_int_p),
+                _as_pointer(vertsPerFace,_int_p)
+            )
+            return
+
+        vertices = np.ascontiguousarray(vertices,dtype=np.float32).reshape(-1,3)
+        if(channels is None and fvar_values is None):
+            OpenSubdiv_clib.subdivider_refine_topology(
+                self._handle,
+                len(vertices),
+                len(vertsPerFace),
+                _as_pointer(vertices,_float_p), # vertices (as c array) 
+                _as_pointer(faceVerts,_int_p), # faceVerts (as c array)
+                _as_pointer(vertsPerFace,_int_p) # vertsPerFace (as c array)
+            )
+            return
+
+        n_channels = 0
+        if(channels is not None):
+            channels = np.ascontiguousarray(channels,dtype=np.float32).reshape(len(vertices),-1)
+            n_channels = channels.shape[1]
+        fvar_width = n_fvar_values = 0
+        if(fvar_values is not None):
+            fvar_values = np.ascontiguousarray(fvar_values,dtype=np.float32)
+            fvar_values = fvar_values.reshape(len(fvar_values),-1)
+            n_fvar_values, fvar_width = fvar_values.shape
+            fvar_indices = np.ascontiguousarray(fvar_indices,dtype=np.int32).reshape(-1)
+            if(len(fvar_indices) != len(faceVerts)):
+                raise ValueError("fvar_indices needs one index per face-vertex (%d), got %d" % (len(faceVerts),len(fvar_indices)))
+        else:
+            fvar_indices = None
+
+        OpenSubdiv_clib.subdivider_refine_primvars(
+            self._handle,
+            len(vertices),
+            len(vertsPerFace),
+            _as_pointer(vertices,_float_p),
+            _as_pointer(faceVerts,_int_p),
+            _as_pointer(vertsPerFace,_int_p),
+            n_channels,
+            _as_pointer(channels,_float_p),
+            fvar_width,
+            n_fvar_values,
+            _as_pointer(fvar_values,_float_p),
+            _as_pointer(fvar_indices,_int_p)
+        )
+
+    def refine_selective(self,vertices,faceVerts,vertsPerFace,face_levels=None,mask=None):
+        # Refines every face to its own level: face_levels has one per face (clamped to the subdivision level), 
+        # or mask selects the faces to refine all the way (the others stay as they are). 
+        # The result is one watertight mesh, read like after refine: where a face borders finer ones 
+        # it picks up their vertices along the shared edges and comes out as an n-gon (see export_faces). 
+        faceVerts, vertsPerFace = _topology_arrays(faceVerts,vertsPerFace)
+        vertices = np.ascontiguousarray(vertices,dtype=np.float32).reshape(-1,3)
+        if(face_levels is None):
+            # Any level above the subdivision level is clamped down to it 
+            face_levels = np.where(np.asarray(mask,dtype=bool).reshape(-1),np.iinfo(np.int32).max,0)
+        face_levels = np.ascontiguousarray(face_levels,dtype=np.int32).reshape(-1)
+        if(len(face_levels) != len(vertsPerFace)):
+            raise ValueError("refine_selective needs one level per face (%d), got %d" % (len(vertsPerFace),len(face_levels)))
+        OpenSubdiv_clib.subdivider_refine_selective(
+            self._handle,
+            len(vertices),
+            len(vertsPerFace),
+            _as_pointer(vertices,_float_p),
+            _as_pointer(faceVerts,_int_p),
+            _as_pointer(vertsPerFace,_int_p),
+            _as_pointer(face_levels,_int_p)
+        )
+
+    def refine_levels(self,vertices,faceVerts,vertsPerFace):
+        # Every level from 0 (the incoming mesh) to the subdivision level in one pass, for about the cost of 
+        # the last level alone. Returns a list with a dict per level, like refine: 'vertices', 'edges', 
+        # 'vertsPerFace' and 'faceVerts', with vertex indices local to the level. 
+        # They are views into one buffer per kind; export_levels has the buffers and the offsets themselves. 
+        faceVerts, vertsPerFace = _topology_arrays(faceVerts,vertsPerFace)
+        vertices = np.ascontiguousarray(vertices,dtype=np.float32).reshape(-1,3)
+        OpenSubdiv_clib.subdivider_refine_levels(
+            self._handle,
+            len(vertices),
+            len(vertsPerFace),
+            _as_pointer(vertices,_float_p),
+            _as_pointer(faceVerts,_int_p),
+            _as_pointer(vertsPerFace,_int_p)
+        )
+        levels = self.export_levels()
+        return [
+            {
+                'vertices':levels['vertices'][v0:v1],
+                'edges':levels['edges'][e0:e1],
+                'vertsPerFace':levels['vertsPerFace'][f0:f1],
+                'faceVerts':levels['faceVerts'][fv0:fv1]
+            }
+            for v0, v1, e0, e1, f0, f1, fv0, fv1 in zip(
+                levels['vert_offsets'][:-1],levels['vert_offsets'][1:],
+                levels['edge_offsets'][:-1],levels['edge_offsets'][1:],
+                levels['face_offsets'][:-1],levels['face_offsets'][1:],
+                levels['face_vert_offsets'][:-1],levels['face_vert_offsets'][1:]
+            )
+        ]
+
+    def submit(self,vertices,faceVerts,vertsPerFace,supersede=True):
+        # Like refine (positions only), but on a background thread: returns a RefineFuture right away. 
+        # The arrays are copied, so they can change or go away once this returns. 
+        # With supersede (the default) every older submission still in flight is cancelled, 
+        # e.g. while an edit is being dragged only the latest state is worth finishing. 
+        faceVerts, vertsPerFace = _topology_arrays(faceVerts,vertsPerFace)
+        vertices = np.ascontiguousarray(vertices,dtype=np.float32).reshape(-1,3)
+        ticket = OpenSubdiv_clib.subdivider_submit(
+            self._handle,
+            len(vertices),
+            len(vertsPerFace),
+            _as_pointer(vertices,_float_p),
+            _as_pointer(faceVerts,_int_p),
+            _as_pointer(vertsPerFace,_int_p),
+            int(supersede)
+        )
+        return RefineFuture(self,ticket)
+
+    #### Results #### 
+    def counts(self):
+        return (
+            OpenSubdiv_clib.subdivider_nn_verts(self._handle),
+            OpenSubdiv_clib.subdivider_nn_edges(self._handle),
+            OpenSubdiv_clib.subdivider_nn_faces(self._handle)
+        )
+
+    def export_mesh(self,vertices,edges,faces):
+        # Copies the results of the last refinement into (C-contiguous float32/int32) numpy arrays. 
+        # Any of them can be None to skip it. faces gets the faces' vertex indices back to back 
+        # (subdivider_nn_face_verts of them), export_faces has the face sizes too. 
+        OpenSubdiv_clib.subdivider_export(
+            self._handle,
+            _as_pointer(vertices,_float_p),
+            _as_pointer(edges,_int_p),
+            _as_pointer(faces,_int_p)
+        )
+
+    def export_vertices(self,dtype=np.float32):
+        # New vertices of the last refinement (nn_verts x 3), float64 ones come straight from a double precision refinement. 
+        nn_verts = OpenSubdiv_clib.subdivider_nn_verts(self._handle)
+        vertices = np.empty((nn_verts,3),dtype=dtype)
+        if(vertices.dtype == np.float64):
+            OpenSubdiv_clib.subdivider_export_vertices_d(self._handle,_as_pointer(vertices,_double_p))
+        else:
+            OpenSubdiv_clib.subdivider_export(self._handle,_as_pointer(vertices,_float_p),None,None)
+        return vertices
+
+    def update_vertices(self,indices,positions,vertices=None):
+        # Moves some control vertices of the last refinement (positions: len(indices) x 3) and recomputes 
+        # only the refined vertices that depend on them. Returns their (sorted) indices and the range 
+        # (first, last + 1) they span, for partial uploads. vertices, if given, is an nn_verts x 3 float32 or float64 
+        # array holding the previous results (see export_vertices), and gets just the changed vertices written into it. 
+        # Returns None when there's nothing to update (no refinement, or one without use_stencils(True)), refine instead then. 
+        indices = np.ascontiguousarray(indices,dtype=np.int32).reshape(-1)
+        positions = np.ascontiguousarray(positions,dtype=np.float32).reshape(-1,3)
+        if(len(positions) != len(indices)):
+            raise ValueError("update_vertices needs one position per index (%d), got %d" % (len(indices),len(positions)))
+        n_dirty = OpenSubdiv_clib.subdivider_update_vertices(
+            self._handle,
+            len(indices),
+            _as_pointer(indices,_int_p),
+            _as_pointer(positions,_float_p)
+        )
+        if(n_dirty < 0):
+            return None
+        dirty = np.empty(n_dirty,dtype=np.int32)
+        dirty_range = np.zeros(2,dtype=np.int32)
+        OpenSubdiv_clib.subdivider_dirty_vertices(self._handle,_as_pointer(dirty,_int_p),_as_pointer(dirty_range,_int_p))
+        if(vertices is not None):
+            if(vertices.dtype == np.float64):
+                OpenSubdiv_clib.subdivider_export_dirty_d(self._handle,_as_pointer(vertices,_double_p))
+            else:
+                OpenSubdiv_clib.subdivider_export_dirty(self._handle,_as_pointer(vertices,_float_p))
+        return dirty, (int(dirty_range[0]),int(dirty_range[1]))
+
+    def export_faces(self):
+        # Faces of the last refinement in CSR form, (vertsPerFace, faceVerts), at any level and for any scheme. 
+        nn_faces = OpenSubdiv_clib.subdivider_nn_faces(self._handle)
+        nn_face_verts = OpenSubdiv_clib.subdivider_nn_face_verts(self._handle)
+        vertsPerFace = np.empty(nn_faces,dtype=np.int32)
+        faceVerts = np.empty(nn_face_verts,dtype=np.int32)
+        OpenSubdiv_clib.subdivider_export_faces(self._handle,_as_pointer(vertsPerFace,_int_p),_as_pointer(faceVerts,_int_p))
+        return vertsPerFace, faceVerts
+
+    def export_levels(self):
+        # Results of refine_levels as concatenated buffers: 'vertices', 'edges', 'vertsPerFace' and 'faceVerts', 
+        # plus level_count + 1 offsets into each ('vert_offsets', 'edge_offsets', 'face_offsets', 'face_vert_offsets'). 
+        n_levels = OpenSubdiv_clib.subdivider_level_count(self._handle)
+        nn_verts, nn_edges, nn_faces = self.counts()
+        vertices = np.empty((nn_verts,3),dtype=np.float32)
+        edges = np.empty((nn_edges,2),dtype=np.int32)
+        OpenSubdiv_clib.subdivider_export(self._handle,_as_pointer(vertices,_float_p),_as_pointer(edges,_int_p),None)
+        vertsPerFace, faceVerts = self.export_faces()
+        offsets = np.zeros((4,n_levels + 1),dtype=np.int32)
+        OpenSubdiv_clib.subdivider_level_offsets(
+            self._handle,
+            _as_pointer(offsets[0],_int_p),
+            _as_pointer(offsets[1],_int_p),
+            _as_pointer(offsets[2],_int_p),
+            _as_pointer(offsets[3],_int_p)
+        )
+        return {
+            'vertices':vertices,
+            'edges':edges,
+            'vertsPerFace':vertsPerFace,
+            'faceVerts':faceVerts,
+            'vert_offsets':offsets[0],
+            'edge_offsets':offsets[1],
+            'face_offsets':offsets[2],
+            'face_vert_offsets':offsets[3]
+        }
+
+    def export_primvars(self):
+        # Refined primvars of the last refinement: 
+        # 'channels' (nn_verts x n_channels), 'fvar_values' (nn_fvar_values x fvar_width) 
+        # and 'fvar_indices' (one per face-vertex, laid out like the faces). 
+        n_channels, fvar_width, nn_fvar_values, nn_fvar_indices = (ctypes.c_int(), ctypes.c_int(), ctypes.c_int(), ctypes.c_int())
+        OpenSubdiv_clib.subdivider_primvar_counts(self._handle,ctypes.byref(n_channels),ctypes.byref(fvar_width),ctypes.byref(nn_fvar_values),ctypes.byref(nn_fvar_indices))
+        nn_verts = OpenSubdiv_clib.subdivider_nn_verts(self._handle)
+
+        channels = np.empty((nn_verts,n_channels.value),dtype=np.float32)
+        fvar_values = np.empty((nn_fvar_values.value,fvar_width.value),dtype=np.float32)
+        fvar_indices = np.empty(nn_fvar_indices.value,dtype=np.int32)
+        OpenSubdiv_clib.subdivider_export_primvars(
+            self._handle,
+            _as_pointer(channels,_float_p),
+            _as_pointer(fvar_values,_float_p),
+            _as_pointer(fvar_indices,_int_p)
+        )
+        return {
+            'channels':channels,
+            'fvar_values':fvar_values,
+            'fvar_indices':fvar_indices
+        }
+
+    def view_results(self):
+        # Zero-copy numpy views of the results of the last refinement. 
+        # These point into the library's own buffers, so they are only valid until the next refinement 
+        # (or until the Subdivider is closed); copy them if they need to live longer. 
+        vertices_p = _float_p()
+        edges_p = _int_p()
+        faces_p = _int_p()
+        face_sizes_p = _int_p()
+        OpenSubdiv_clib.subdivider_buffers(self._handle,ctypes.byref(vertices_p),ctypes.byref(edges_p),ctypes.byref(faces_p),ctypes.byref(face_sizes_p))
+
+        def view(pointer,shape,dtype):
+            if(not pointer or 0 in shape):
+                return np.empty(shape,dtype=dtype)
+            return np.ctypeslib.as_array(pointer,shape=shape)
+
+        nverts, nedges, nfaces = self.counts()
+        nface_verts = OpenSubdiv_clib.subdivider_nn_face_verts(self._handle)
+        return {
+            'vertices' : view(vertices_p,(nverts,3),np.float32),
+            'edges' : view(edges_p,(nedges,2),np.int32),
+            'faces' : view(faces_p,(nface_verts,),np.int32), # CSR, see export_faces
+            'vertsPerFace' : view(face_sizes_p,(nfaces,),np.int32)
+        }
+
+    #### Batch #### 
+    def refine_batch(self,vertices,faceVerts,vertsPerFace,vert_offsets,face_offsets):
+        # Subdivides many meshes in one call, in parallel across cores. 
+        # The input is concatenated, mesh m owning vertices[vert_offsets[m]:vert_offsets[m+1]] 
+        # and vertsPerFace[face_offsets[m]:face_offsets[m+1]] (faceVerts index each mesh's own vertices). 
+        # Returns the concatenated results plus their offset tables (indices stay local to each mesh). 
+        # Offsets that go backwards or past the end of the input raise a ValueError. 
+        vertices = np.ascontiguousarray(vertices,dtype=np.float32).reshape(-1,3)
+        faceVerts, vertsPerFace = _topology_arrays(faceVerts,vertsPerFace)
+        vert_offsets = np.ascontiguousarray(vert_offsets,dtype=np.int32).reshape(-1)
+        face_offsets = np.ascontiguousarray(face_offsets,dtype=np.int32).reshape(-1)
+        if(len(vert_offsets) == 0 or len(vert_offsets) != len(face_offsets)):
+            raise ValueError("refine_batch needs n_meshes + 1 offsets of each kind, got %d and %d" % (len(vert_offsets),len(face_offsets)))
+        n_meshes = len(vert_offsets) - 1
+        status = OpenSubdiv_clib.subdivider_refine_batch(
+            self._handle,
+            n_meshes,
+            _as_pointer(vert_offsets,_int_p),
+            _as_pointer(face_offsets,_int_p),
+            len(vertices),
+            len(vertsPerFace),
+            len(faceVerts),
+            _as_pointer(vertices,_float_p),
+            _as_pointer(faceVerts,_int_p),
+            _as_pointer(vertsPerFace,_int_p)
+        )
+        if(status != 0):
+            raise ValueError("refine_batch: the offsets have to ascend and stay within the %d vertices and %d faces" % (len(vertices),len(vertsPerFace)))
+
+        new_vert_offsets = np.empty(n_meshes + 1,dtype=np.int32)
+        new_edge_offsets = np.empty(n_meshes + 1,dtype=np.int32)
+        new_face_offsets = np.empty(n_meshes + 1,dtype=np.int32)
+        new_face_vert_offsets = np.empty(n_meshes + 1,dtype=np.int32)
+        OpenSubdiv_clib.subdivider_batch_offsets(
+            self._handle,
+            _as_pointer(new_vert_offsets,_int_p),
+            _as_pointer(new_edge_offsets,_int_p),
+            _as_pointer(new_face_offsets,_int_p),
+            _as_pointer(new_face_vert_offsets,_int_p)
+        )
+
+        new_vertices = np.empty((new_vert_offsets[-1],3),dtype=np.float32)
+        new_edges = np.empty((new_edge_offsets[-1],2),dtype=np.int32)
+        new_vertsPerFace = np.empty(new_face_offsets[-1],dtype=np.int32)
+        new_faceVerts = np.empty(new_face_vert_offsets[-1],dtype=np.int32)
+        OpenSubdiv_clib.subdivider_batch_export(
+            self._handle,
+            _as_pointer(new_vertices,_float_p),
+            _as_pointer(new_edges,_int_p),
+            _as_pointer(new_vertsPerFace,_int_p),
+            _as_pointer(new_faceVerts,_int_p)
+        )
+        return {
+            'vertices' : new_vertices,
+            'edges' : new_edges,
+            'vertsPerFace' : new_vertsPerFace,
+            'faceVerts' : new_faceVerts,
+            'vert_offsets' : new_vert_offsets,
+            'edge_offsets' : new_edge_offsets,
+            'face_offsets' : new_face_offsets,
+            'face_vert_offsets' : new_face_vert_offsets
+        }
+
+    #### Topology Cache #### 
+    # The refined topology of the last few meshes is cached, 
+    # so subdividing the same faces again (e.g. an animated mesh) only interpolates the vertices. 
+    def set_cache_size(self,cache_size):
+        OpenSubdiv_clib.subdivider_cache_size(self._handle,cache_size)
+
+    def invalidate_cache(self):
+        OpenSubdiv_clib.subdivider_cache_invalidate(self._handle)
+
+    def evict_topology(self,faceVerts,vertsPerFace,n_verts):
+        # Evicts the topology as cached at the current subdivision level. 
+        faceVerts, vertsPerFace = _topology_arrays(faceVerts,vertsPerFace)
+        return bool(OpenSubdiv_clib.subdivider_cache_evict(
+            self._handle,
+            n_verts,
+            len(vertsPerFace),
+            _as_pointer(faceVerts,_int_p),
+            _as_pointer(vertsPerFace,_int_p)
+        ))
+
+    def cache_hit(self):
+        return bool(OpenSubdiv_clib.subdivider_cache_hit(self._handle))
+
+    def set_disk_cache(self,directory):
+        # Also keep refined topologies (with their stencils) as files in `directory` (which has to exist), 
+        # so later sessions / other processes map them instead of refining again. None turns it off. 
+        # Only refinements with use_stencils(True) write files (the stencils are what they hold), all of them read them. 
+        # Files from another OpenSubdiv version or with other settings are ignored and replaced. 
+        OpenSubdiv_clib.subdivider_disk_cache(self._handle,None if directory is None else os.fsencode(directory))
+
+    def disk_cache_hit(self):
+        return bool(OpenSubdiv_clib.subdivider_disk_cache_hit(self._handle))
+
+    def use_stencils(self,enabled):
+        # Evaluate through a precomputed last-level stencil table (built once per cached topology). 
+        # Worth it when the same cage is subdivided over and over, especially at level 3 and up. 
+        # update_vertices needs it. 
+        OpenSubdiv_clib.subdivider_use_stencils(self._handle,int(enabled))
+
+    def set_reorder(self,enabled):
+        # Hand out refined meshes (refine, refine_batch) in a vertex cache friendly order: faces ordered for reuse 
+        # of their vertices, vertices numbered by first use. Better locality for GPU uploads, BVH builds, smoothing. 
+        # The order is cached with the topology, see export_order for the permutations. 
+        OpenSubdiv_clib.subdivider_reorder(self._handle,int(enabled))
+
+    def export_order(self):
+        # (vertex_order, face_order) of the last refinement: result vertex i is OpenSubdiv's refined vertex vertex_order[i], 
+        # and likewise for the faces. Both are the identity without set_reorder. 
+        nn_verts, _, nn_faces = self.counts()
+        vertex_order = np.empty(nn_verts,dtype=np.int32)
+        face_order = np.empty(nn_faces,dtype=np.int32)
+        OpenSubdiv_clib.subdivider_export_order(self._handle,_as_pointer(vertex_order,_int_p),_as_pointer(face_order,_int_p))
+        return vertex_order, face_order
+
+    #### Stats #### 
+    # Per-stage times (ms), element counts and bytes allocated of the last call (copy-out included), 
+    # and the running totals since the Subdivider was created or reset_stats was called. 
+    # All zeros if the library was built with -DSUBDIVIDER_NO_STATS (see stats_enabled). 
+    def stats(self):
+        last = SubdividerStats()
+        total = SubdividerStats()
+        OpenSubdiv_clib.subdivider_stats_get(self._handle,ctypes.byref(last),ctypes.byref(total))
+        return last.as_dict(), total.as_dict()
+
+    def reset_stats(self):
+        OpenSubdiv_clib.subdivider_stats_reset(self._handle)
+
+    @staticmethod
+    def stats_enabled():
+        return bool(OpenSubdiv_clib.subdivider_stats_enabled())
+
+    #### Kernels #### 
+    # Turns the AVX2 + FMA stencil kernels off (or back on) for every Subdivider in the process, 
+    # to compare them with the SSE / scalar ones. Returns whether they're used now. 
+    @staticmethod
+    def use_avx2(enabled):
+        return bool(OpenSubdiv_clib.subdivider_use_avx2(int(enabled)))
+
+    #### Limit surface #### 
+    def set_limit_isolation(self,isolation):
+        # Adaptive refinement depth used by evaluate_limit (1-10, 4 by default). 
+        OpenSubdiv_clib.subdivider_limit_isolation(self._handle,isolation)
+
+    def evaluate_limit(self,vertices,faceVerts,vertsPerFace,sample_faces,sample_uvs,derivatives=True):
+        # Exact limit surface positions (and dP/du, dP/dv) at (ptex face, u, v) samples, 
+        # without refining the whole mesh. See ptex_faces for the face ids of n-gons. 
+        # Returns P, or (P, dPdu, dPdv) with derivatives=True, each n_samples x 3. 
+        # Samples off the mesh (face id out of range, u or v outside [0, 1] or NaN) come back as zeros. 
+        vertices = np.ascontiguousarray(vertices,dtype=np.float32).reshape(-1,3)
+        faceVerts, vertsPerFace = _topology_arrays(faceVerts,vertsPerFace)
+        sample_faces = np.ascontiguousarray(sample_faces,dtype=np.int32).reshape(-1)
+        sample_uvs = np.ascontiguousarray(sample_uvs,dtype=np.float32).reshape(-1,2)
+        if(len(sample_faces) != len(sample_uvs)):
+            raise ValueError("sample_faces and sample_uvs need the same length (%d != %d)" % (len(sample_faces),len(sample_uvs)))
+
+        P = np.zeros((len(sample_faces),3),dtype=np.float32)
+        dPdu = np.zeros_like(P) if derivatives else None
+        dPdv = np.zeros_like(P) if derivatives else None
+        OpenSubdiv_clib.subdivider_evaluate_limit(
+            self._handle,
+            len(vertices),
+            len(vertsPerFace),
+            _as_pointer(vertices,_float_p),
+            _as_pointer(faceVerts,_int_p),
+            _as_pointer(vertsPerFace,_int_p),
+            len(sample_faces),
+            _as_pointer(sample_faces,_int_p),
+            _as_pointer(sample_uvs,_float_p),
+            _as_pointer(P,_float_p),
+            _as_pointer(dPdu,_float_p),
+            _as_pointer(dPdv,_float_p)
+        )
+        if(derivatives):
+            return P, dPdu, dPdv
+        return P
+
+    def ptex_faces(self,vertsPerFace):
+        # First ptex face id of every face (len(vertsPerFace) + 1 offsets): 
+        # quads (triangles with Loop) have one ptex face, other faces one per corner. 
+        vertsPerFace = np.ascontiguousarray(vertsPerFace,dtype=np.int32).reshape(-1)
+        offsets = np.zeros(len(vertsPerFace) + 1,dtype=np.int32)
+        OpenSubdiv_clib.subdivider_ptex_faces(self._handle,len(vertsPerFace),_as_pointer(vertsPerFace,_int_p),_as_pointer(offsets,_int_p))
+        return offsets
+
+# pysubdivide uses one Subdivider per thread, so calls from different threads never share state 
+# (and each thread keeps its own topology cache). 
+_thread_local = threading.local()
+
+# Socket of the subdivision_worker pool pysubdivide / pysubdivide_batch send their work to, None refines in process 
+_worker_socket = None
+
+def use_workers(enabled=True,workers=0,socket_path=None,disk_cache=None):
+    # Moves pysubdivide and pysubdivide_batch out of process, into a subdivision_worker pool (see worker.py), 
+    # started here unless one is already up. A crash on bad input then costs a worker rather than the host, 
+    # and batches spread over the pool's processes. use_workers(False) goes back to refining in process. 
+    global _worker_socket
+    from pyOpenSubdiv import worker
+    if(enabled):
+        socket_path = socket_path or worker.default_socket_path()
+        worker.start_pool(workers,socket_path,disk_cache=disk_cache)
+        _worker_socket = socket_path
+    else:
+        _worker_socket = None
+
+def thread_subdivider():
+    if(_worker_socket is not None):
+        if(getattr(_thread_local,'worker_socket',None) != _worker_socket):
+            from pyOpenSubdiv.worker import WorkerSubdivider
+            _thread_local.worker = WorkerSubdivider(socket_path=_worker_socket)
+            _thread_local.worker_socket = _worker_socket
+        return _thread_local.worker
+    if(not hasattr(_thread_local,'subdivider')):
+        _thread_local.subdivider = Subdivider()
+    return _thread_local.subdivider
+
 def pysubdivide(subdivision_level,
     vertices,    
-    faces, # Used in the maxlevel = 0 case
     faceVerts,
     vertsPerFace,
     verbose=False,    
@@ -19,117 +792,74 @@ def pysubdivide(subdivision_level,
     Documentation
     """   
 
-    ################ Subdivide ################
-    subdivider_settings = OpenSubdiv_clib.subdivider_settings
-    subdivider_settings.argtypes = [
-        ctypes.c_int, # maxlevel 
-        ctypes.c_int # verbose
-    ]    
-
-    subdivider_settings(subdivision_level,verbose)
-
-    refine_topology = OpenSubdiv_clib.subdivider_refine_topology
-    refine_topology.argtypes = [
-        ctypes.c_int, # n_verts
-        ctypes.c_int, # n_faces     
-        ctypes.POINTER((ctypes.c_float)*3), # vertices 
-        ctypes.POINTER(ctypes.c_int), # faceVerts
-        ctypes.POINTER(ctypes.c_int) # vertsPerFace
-    ]
-    
-    n_verts = len(vertices)
-    n_faces = len(vertsPerFace)
-    vertices_array = ctypes.ARRAY(n_verts,ctypes.c_float*3)(*[(ctypes.c_float*3)(*vert) for vert in vertices])
-    faceVerts_array = (ctypes.c_int*len(faceVerts))(*faceVerts)
-    vertsPerFace_array = (ctypes.c_int*n_faces)(*vertsPerFace)
-
-    refine_topology(
-        n_verts,
-        n_faces,
-        vertices_array, # vertices (as c array) 
-        faceVerts_array, # faceVerts (as c array)
-        vertsPerFace_array # vertsPerFace (as c array)
-    )
-
-    if(subdivision_level <= 0):
-        OpenSubdiv_clib.nn_edges.restypes = ctypes.c_int
-        new_nedges = OpenSubdiv_clib.nn_edges()
-
-        #### Extract New Edges #### 
-        new_edges = (ctypes.ARRAY(new_nedges,ctypes.c_int*2))(*[(ctypes.c_int*2)(*[0,0])])
-
-        OpenSubdiv_clib.new_edges.argtypes = [ctypes.ARRAY(new_nedges,ctypes.c_int*2)]
-        OpenSubdiv_clib.new_edges(new_edges)
-
-        #### Reconstruct faces #### 
-        if(not faces):
-            # This block will never run, because I'm passing faces in as a parameter. 
-            # But in the case that you wanted to reconstruct the faces from verstPerface and faceVerts,
-            # this is the code to use. 
-            # It's slightly slower than just passing the faces in, but not enormously. 
-            arr_pos = 0         
-            faces = [] 
-            for i,verts_in_face in enumerate(vertsPerFace):
-                face = []         
-                for j in range(verts_in_face): 
-                    face.append(faceVerts[arr_pos + j])
-                faces.append(face)
-                arr_pos+= verts_in_face            
-        
-        #### Results #### 
-        new_mesh = {
-            'vertices' : vertices,
-            'edges' : np.ctypeslib.as_array(new_edges).tolist(),
-            'faces' : faces
-        }
-        return new_mesh             
-    elif(subdivision_level > 0):
+    if(_pysubdivision is not None and _worker_socket is None):
+        ################ Subdivide (native) ################
+        result = _pysubdivision.subdivide(subdivision_level,vertices,faceVerts,vertsPerFace,verbose)
+        new_vertices = result['vertices']
+        new_edges = result['edges']
+        new_vertsPerFace, new_faceVerts = result['vertsPerFace'], result['faceVerts']
+    else:
+        ################ Subdivide ################
+        subdivider = thread_subdivider()
+        subdivider.settings(subdivision_level,verbose)
+        subdivider.refine(vertices,faceVerts,vertsPerFace)
+
+        new_nverts, new_nedges, new_nfaces = subdivider.counts()
+
         ################ Get Results ################
-        #### Gather New Mesh Information ####
-        OpenSubdiv_clib.nn_verts.restypes = ctypes.c_int 
-        new_nverts = OpenSubdiv_clib.nn_verts()
-
-        OpenSubdiv_clib.nn_edges.restypes = ctypes.c_int
-        new_nedges = OpenSubdiv_clib.nn_edges()
-
-        OpenSubdiv_clib.nn_faces.restypes = ctypes.c_int
-        new_nfaces = OpenSubdiv_clib.nn_faces()
-
-        #### Extract New Vertices #### 
-        # new_vert_arrays = []
-        # for i in range(new_nverts):
-        #     new_vert_arrays.append((ctypes.c_float*3)(*[0,0,0]))
-        # (ctypes.c_float*3)(*[0,0,0])
-        # Turns out you can do this in one line 
-        # It's absolutely absurd, though. 
-        new_vertices = (ctypes.ARRAY(new_nverts,ctypes.c_float*3))(*[(ctypes.c_float*3)(*[0,0,0])])
-
-        OpenSubdiv_clib.new_vertices.argtypes = [ctypes.ARRAY(new_nverts,ctypes.c_float*3)]
-        OpenSubdiv_clib.new_vertices(new_vertices)
-
-        #### Extract New Edges #### 
-        new_edges = (ctypes.ARRAY(new_nedges,ctypes.c_int*2))(*[(ctypes.c_int*2)(*[0,0])])
-
-        OpenSubdiv_clib.new_edges.argtypes = [ctypes.ARRAY(new_nedges,ctypes.c_int*2)]
-        OpenSubdiv_clib.new_edges(new_edges)
-
-        #### Extract New Faces #### 
-        new_faces = (ctypes.ARRAY(new_nfaces,ctypes.c_int*4))(*[(ctypes.c_int*4)(*[0,0,0,0])])
-        OpenSubdiv_clib.new_faces.argtypes = [ctypes.ARRAY(new_nfaces,ctypes.c_int*4)]
-        OpenSubdiv_clib.new_faces(new_faces)
-
-        ################ Return ################
-        # print(timeit.timeit(lambda: np.ctypeslib.as_array(new_vertices),number=10000)) # This is instantaneous 
-        # print(timeit.timeit(lambda: np.ctypeslib.as_array(new_vertices).tolist(),number=10000)) # This is ridiculously slow 
-
-        # tolist() is quite slow but it seems necessary for blender. 
-        # Er, well, maybe it's not that bad idk. 
-        new_mesh = {
-            'vertices' : np.ctypeslib.as_array(new_vertices).tolist(),
-            'edges' : np.ctypeslib.as_array(new_edges).tolist(),
-            'faces' : np.ctypeslib.as_array(new_faces).tolist()
-        }
-        return new_mesh 
+        #### Extract New Vertices, Edges and Faces #### 
+        # Straight into (contiguous) numpy arrays. Faces come back in CSR form at every level, 
+        # so ngons (level 0) need no reconstruction. 
+        new_vertices = np.empty((new_nverts,3),dtype=np.float32)
+        new_edges = np.empty((new_nedges,2),dtype=np.int32)
+        subdivider.export_mesh(new_vertices,new_edges,None)
+        new_vertsPerFace, new_faceVerts = subdivider.export_faces()
+
+    ################ Return ################
+    # tolist() is quite slow but it seems necessary for blender. 
+    # Er, well, maybe it's not that bad idk. 
+    new_mesh = {
+        'vertices' : new_vertices.tolist(),
+        'edges' : new_edges.tolist(),
+        'faces' : face_lists(new_vertsPerFace,new_faceVerts)
+    }
+    return new_mesh 
+
+def pysubdivide_batch(subdivision_level,meshes):
+    # meshes: list of (vertices, faceVerts, vertsPerFace), e.g. one per body in a Sverchok tree. 
+    # All of them go through a single native call, returns one dict per mesh (like pysubdivide with subdivision_level > 0). 
+    if(_worker_socket is not None):
+        # One job per mesh, spread over the worker pool 
+        from pyOpenSubdiv import worker
+        return [
+            {
+                'vertices' : result['vertices'].tolist(),
+                'edges' : result['edges'].tolist(),
+                'faces' : face_lists(result['vertsPerFace'],result['faces'])
+            }
+            for result in worker.refine_many(subdivision_level,meshes,_worker_socket)
+        ]
+
+    vert_offsets = np.cumsum([0] + [len(mesh[0]) for mesh in meshes])
+    face_offsets = np.cumsum([0] + [len(mesh[2]) for mesh in meshes])
+    vertices = np.concatenate([np.asarray(mesh[0],dtype=np.float32).reshape(-1,3) for mesh in meshes]) if meshes else np.empty((0,3),dtype=np.float32)
+    faceVerts = np.concatenate([np.asarray(mesh[1],dtype=np.int32).reshape(-1) for mesh in meshes]) if meshes else np.empty(0,dtype=np.int32)
+    vertsPerFace = np.concatenate([np.asarray(mesh[2],dtype=np.int32).reshape(-1) for mesh in meshes]) if meshes else np.empty(0,dtype=np.int32)
+
+    subdivider = thread_subdivider()
+    subdivider.settings(subdivision_level,False)
+    batch = subdivider.refine_batch(vertices,faceVerts,vertsPerFace,vert_offsets,face_offsets)
+
+    new_meshes = []
+    for m in range(len(meshes)):
+        new_meshes.append({
+            'vertices' : batch['vertices'][batch['vert_offsets'][m]:batch['vert_offsets'][m+1]].tolist(),
+            'edges' : batch['edges'][batch['edge_offsets'][m]:batch['edge_offsets'][m+1]].tolist(),
+            'faces' : face_lists(
+                batch['vertsPerFace'][batch['face_offsets'][m]:batch['face_offsets'][m+1]],
+                batch['faceVerts'][batch['face_vert_offsets'][m]:batch['face_vert_offsets'][m+1]])
+        })
+    return new_meshes
 
 
 # [ ] Convert to actual unit test 
@@ -159,7 +889,7 @@ def test_pysubdivide():
             faceVerts = list(chain.from_iterable(faces))
             vertsPerFace = [len(face) for face in faces]
 
-            test_mesh = pysubdivide(maxlevel,verts,faces,faceVerts,vertsPerFace,verbose=False)
+            test_mesh = pysubdivide(maxlevel,verts,faceVerts,vertsPerFace,verbose=False)
     print()
 
     print('Verbose Test')
@@ -170,14 +900,14 @@ def test_pysubdivide():
     faceVerts = list(chain.from_iterable(faces))
     vertsPerFace = [len(face) for face in faces]
 
-    test_mesh = pysubdivide(1,verts,faces,faceVerts,vertsPerFace,verbose=True)
+    test_mesh = pysubdivide(1,verts,faceVerts,vertsPerFace,verbose=True)
     print()
 
     print('Runtime')
     for maxlevel in range(3):
         iterations = 10000
 
-        runtime = timeit.timeit(lambda: pysubdivide(maxlevel,verts,faces,faceVerts,vertsPerFace,verbose=False),number=iterations)
+        runtime = timeit.timeit(lambda: pysubdivide(maxlevel,verts,faceVerts,vertsPerFace,verbose=False),number=iterations)
         print(f'Cube: {runtime:.3f}s @ {maxlevel} x {iterations} ')
     print()
     
@@ -0,0 +1,1021 @@
+import concurrent.futures
+import os
+import signal
+import socket
+import subprocess
+import tempfile
+import threading
+import time
+import unittest
+from itertools import chain
+
+import numpy as np
+
+from pyOpenSubdiv import pysubdivision
+from pyOpenSubdiv import test_topology
+
+# Every refinement path is checked against the plain one: level by level, single threaded, no caches,
+# OpenSubdiv's order (see reference). Needs the built library (make) in pyOpenSubdiv/clib.
+# Run from the package directory: python3 -m unittest pyOpenSubdiv.test_refinement (or make test)
+
+MESHES = {
+    'cube':test_topology.cube,
+    'triangles':test_topology.triangles,
+    'ngons':test_topology.ngons,
+    'ngons2':test_topology.ngons2,
+    'suzanne':test_topology.suzanne
+}
+LEVELS = (1,2,3)
+
+def mesh_arrays(mesh):
+    vertices = np.array(mesh['verts'],dtype=np.float32)
+    faceVerts = np.array(list(chain.from_iterable(mesh['faces'])),dtype=np.int32)
+    vertsPerFace = np.array([len(face) for face in mesh['faces']],dtype=np.int32)
+    return vertices, faceVerts, vertsPerFace
+
+def results(subdivider):
+    # Copies of the last refinement's results
+    nn_verts, nn_edges, nn_faces = subdivider.counts()
+    vertices = np.empty((nn_verts,3),dtype=np.float32)
+    edges = np.empty((nn_edges,2),dtype=np.int32)
+    subdivider.export_mesh(vertices,edges,None)
+    vertsPerFace, faceVerts = subdivider.export_faces()
+    return {'vertices':vertices,'edges':edges,'vertsPerFace':vertsPerFace,'faceVerts':faceVerts}
+
+def reference(level,mesh,scheme='catmark'):
+    subdivider = pysubdivision.Subdivider(level,threads=1)
+    subdivider.set_scheme(scheme)
+    subdivider.set_cache_size(0)
+    subdivider.refine(*mesh)
+    return results(subdivider)
+
+def cases():
+    # (name, level, scheme, mesh arrays), Loop only for the triangle mesh
+    for name, mesh in MESHES.items():
+        for level in LEVELS:
+            yield name, level, 'catmark', mesh_arrays(mesh)
+    for level in LEVELS:
+        yield 'triangles', level, 'loop', mesh_arrays(test_topology.triangles)
+
+def face_sides(vertsPerFace,faceVerts):
+    # Every face side as a directed (a, b) pair
+    sides = []
+    for face in pysubdivision.face_lists(vertsPerFace,faceVerts):
+        sides += [(face[j],face[(j + 1) % len(face)]) for j in range(len(face))]
+    return sides
+
+def undirected(pairs):
+    return {(min(a,b),max(a,b)) for a, b in pairs}
+
+def tolerance(vertices):
+    # Stencil and level by level sums round differently, by a few ulps of the mesh's size
+    return 1e-5 * max(1.0,float(np.abs(vertices).max()))
+
+def assert_same(actual,expected,atol=0.0):
+    # Same topology, and the same positions (or within atol)
+    for key in expected:
+        if(key == 'vertices' and atol > 0):
+            np.testing.assert_allclose(actual[key],expected[key],rtol=0,atol=atol)
+        else:
+            np.testing.assert_array_equal(actual[key],expected[key])
+
+################ Topology cache ################
+class TestCache(unittest.TestCase):
+    def test_moved_positions_are_a_hit(self):
+        for name, level, scheme, mesh in cases():
+            with self.subTest(mesh=name,level=level,scheme=scheme):
+                vertices, faceVerts, vertsPerFace = mesh
+                moved = (vertices * np.float32(1.5) + np.float32(0.25),faceVerts,vertsPerFace)
+                subdivider = pysubdivision.Subdivider(level)
+                subdivider.set_scheme(scheme)
+                subdivider.refine(*mesh)
+                self.assertFalse(subdivider.cache_hit())
+                subdivider.refine(*moved)
+                self.assertTrue(subdivider.cache_hit())
+                assert_same(results(subdivider),reference(level,moved,scheme))
+
+    def test_evict_and_invalidate(self):
+        vertices, faceVerts, vertsPerFace = mesh = mesh_arrays(test_topology.suzanne)
+        subdivider = pysubdivision.Subdivider(2)
+        subdivider.refine(*mesh)
+        subdivider.refine(*mesh)
+        self.assertTrue(subdivider.cache_hit())
+        self.assertTrue(subdivider.evict_topology(faceVerts,vertsPerFace,len(vertices)))
+        self.assertFalse(subdivider.evict_topology(faceVerts,vertsPerFace,len(vertices)))
+        subdivider.refine(*mesh)
+        self.assertFalse(subdivider.cache_hit())
+        subdivider.refine(*mesh)
+        self.assertTrue(subdivider.cache_hit())
+        subdivider.invalidate_cache()
+        subdivider.refine(*mesh)
+        self.assertFalse(subdivider.cache_hit())
+
+    def test_scheme_is_part_of_the_key(self):
+        mesh = mesh_arrays(test_topology.triangles)
+        subdivider = pysubdivision.Subdivider(2)
+        seen = set()
+        for scheme in ('catmark','loop','bilinear','catmark'):
+            with self.subTest(scheme=scheme):
+                subdivider.set_scheme(scheme)
+                subdivider.refine(*mesh)
+                self.assertEqual(subdivider.cache_hit(),scheme in seen)
+                assert_same(results(subdivider),reference(2,mesh,scheme))
+                seen.add(scheme)
+
+################ Stencils ################
+class TestStencils(unittest.TestCase):
+    def test_matches_level_by_level(self):
+        for name, level, scheme, mesh in cases():
+            with self.subTest(mesh=name,level=level,scheme=scheme):
+                vertices, faceVerts, vertsPerFace = mesh
+                moved = (vertices * np.float32(1.5) + np.float32(0.25),faceVerts,vertsPerFace)
+                subdivider = pysubdivision.Subdivider(level)
+                subdivider.set_scheme(scheme)
+                subdivider.use_stencils(True)
+                subdivider.refine(*mesh)
+                expected = reference(level,mesh,scheme)
+                assert_same(results(subdivider),expected,tolerance(expected['vertices']))
+                # Moved positions go through the cached stencil table
+                subdivider.refine(*moved)
+                self.assertTrue(subdivider.cache_hit())
+                expected = reference(level,moved,scheme)
+                assert_same(results(subdivider),expected,tolerance(expected['vertices']))
+
+################ Edges ################
+class TestEdges(unittest.TestCase):
+    def test_every_side_once(self):
+        for name, level, scheme, mesh in cases():
+            with self.subTest(mesh=name,level=level,scheme=scheme):
+                refined = reference(level,mesh,scheme)
+                edges = [tuple(edge) for edge in refined['edges'].tolist()]
+                self.assertEqual(len(undirected(edges)),len(edges),"duplicate edges")
+                self.assertEqual(undirected(edges),undirected(face_sides(refined['vertsPerFace'],refined['faceVerts'])))
+
+    def test_level_zero(self):
+        vertices, faceVerts, vertsPerFace = mesh_arrays(test_topology.ngons2)
+        refined = reference(0,(vertices,faceVerts,vertsPerFace))
+        edges = [tuple(edge) for edge in refined['edges'].tolist()]
+        self.assertEqual(len(undirected(edges)),len(edges))
+        self.assertEqual(undirected(edges),undirected(face_sides(vertsPerFace,faceVerts)))
+
+################ Results ################
+class TestResults(unittest.TestCase):
+    def test_views_match_copies(self):
+        subdivider = pysubdivision.Subdivider(2)
+        subdivider.refine(*mesh_arrays(test_topology.suzanne))
+        refined = results(subdivider)
+        views = subdivider.view_results()
+        np.testing.assert_array_equal(views['vertices'],refined['vertices'])
+        np.testing.assert_array_equal(views['edges'],refined['edges'])
+        np.testing.assert_array_equal(views['vertsPerFace'],refined['vertsPerFace'])
+        np.testing.assert_array_equal(views['faces'],refined['faceVerts'])
+        # Any of the exports can be skipped
+        vertices = np.zeros_like(refined['vertices'])
+        subdivider.export_mesh(vertices,None,None)
+        np.testing.assert_array_equal(vertices,refined['vertices'])
+
+################ Handle ################
+class TestHandle(unittest.TestCase):
+    def test_instances_are_independent(self):
+        cube = mesh_arrays(test_topology.cube)
+        suzanne = mesh_arrays(test_topology.suzanne)
+        first = pysubdivision.Subdivider(1)
+        second = pysubdivision.Subdivider(2)
+        first.refine(*cube)
+        second.refine(*suzanne)
+        assert_same(results(first),reference(1,cube))
+        assert_same(results(second),reference(2,suzanne))
+        # Each has its own cache
+        second.refine(*suzanne)
+        self.assertTrue(second.cache_hit())
+        first.settings(2)
+        first.refine(*suzanne)
+        self.assertFalse(first.cache_hit())
+        assert_same(results(first),results(second))
+
+    def test_one_subdivider_per_thread(self):
+        others = []
+        thread = threading.Thread(target=lambda: others.append(pysubdivision.thread_subdivider()))
+        thread.start()
+        thread.join()
+        self.assertIs(pysubdivision.thread_subdivider(),pysubdivision.thread_subdivider())
+        self.assertIsNot(others[0],pysubdivision.thread_subdivider())
+
+    def test_results_before_refine(self):
+        subdivider = pysubdivision.Subdivider(2)
+        self.assertEqual(subdivider.counts(),(0,0,0))
+        self.assertEqual(len(subdivider.view_results()['vertices']),0)
+        vertsPerFace, faceVerts = subdivider.export_faces()
+        self.assertEqual((len(vertsPerFace),len(faceVerts)),(0,0))
+        subdivider.export_mesh(np.empty((0,3),dtype=np.float32),np.empty((0,2),dtype=np.int32),np.empty(0,dtype=np.int32))
+
+################ Batch ################
+def batch_input(meshes):
+    # The meshes concatenated, with their offsets
+    return (
+        np.concatenate([mesh[0] for mesh in meshes]),
+        np.concatenate([mesh[1] for mesh in meshes]),
+        np.concatenate([mesh[2] for mesh in meshes]),
+        np.cumsum([0] + [len(mesh[0]) for mesh in meshes]),
+        np.cumsum([0] + [len(mesh[2]) for mesh in meshes])
+    )
+
+def batch_mesh(batch,m):
+    # Mesh m of refine_batch's results
+    return {
+        'vertices':batch['vertices'][batch['vert_offsets'][m]:batch['vert_offsets'][m + 1]],
+        'edges':batch['edges'][batch['edge_offsets'][m]:batch['edge_offsets'][m + 1]],
+        'vertsPerFace':batch['vertsPerFace'][batch['face_offsets'][m]:batch['face_offsets'][m + 1]],
+        'faceVerts':batch['faceVerts'][batch['face_vert_offsets'][m]:batch['face_vert_offsets'][m + 1]]
+    }
+
+class TestBatch(unittest.TestCase):
+    def test_matches_refine(self):
+        meshes = [mesh_arrays(mesh) for mesh in MESHES.values()]
+        for level in LEVELS:
+            with self.subTest(level=level):
+                batch = pysubdivision.Subdivider(level).refine_batch(*batch_input(meshes))
+                for m, mesh in enumerate(meshes):
+                    expected = reference(level,mesh)
+                    assert_same(batch_mesh(batch,m),expected,tolerance(expected['vertices']))
+
+    def test_bad_offsets(self):
+        vertices, faceVerts, vertsPerFace = mesh = mesh_arrays(test_topology.cube)
+        n_verts, n_faces = len(vertices), len(vertsPerFace)
+        subdivider = pysubdivision.Subdivider(1)
+        for vert_offsets, face_offsets in (
+            ([],[]), # no meshes, not even the leading 0
+            ([0,n_verts],[0]), # tables of different lengths
+            ([0,n_verts + 1],[0,n_faces]), # past the end
+            ([0,n_verts],[0,n_faces + 1]),
+            ([0,n_verts,4],[0,n_faces,n_faces]), # backwards
+        ):
+            with self.subTest(vert_offsets=vert_offsets,face_offsets=face_offsets):
+                with self.assertRaises(ValueError):
+                    subdivider.refine_batch(vertices,faceVerts,vertsPerFace,vert_offsets,face_offsets)
+        # Still usable afterwards
+        batch = subdivider.refine_batch(vertices,faceVerts,vertsPerFace,[0,n_verts],[0,n_faces])
+        expected = reference(1,mesh)
+        assert_same(batch_mesh(batch,0),expected,tolerance(expected['vertices']))
+
+################ Threads ################
+class TestThreads(unittest.TestCase):
+    def test_thread_count_does_not_change_results(self):
+        for name, level, scheme, mesh in cases():
+            for stencils in (False,True):
+                with self.subTest(mesh=name,level=level,scheme=scheme,stencils=stencils):
+                    outputs = []
+                    for threads in (1,2,0):
+                        subdivider = pysubdivision.Subdivider(level,threads=threads)
+                        subdivider.set_scheme(scheme)
+                        subdivider.use_stencils(stencils)
+                        subdivider.refine(*mesh)
+                        outputs.append(results(subdivider))
+                    for output in outputs[1:]:
+                        assert_same(output,outputs[0])
+
+################ Primvars ################
+class TestPrimvars(unittest.TestCase):
+    def test_positions_as_a_channel(self):
+        for name, level, scheme, mesh in cases():
+            with self.subTest(mesh=name,level=level,scheme=scheme):
+                vertices, faceVerts, vertsPerFace = mesh
+                subdivider = pysubdivision.Subdivider(level)
+                subdivider.set_scheme(scheme)
+                subdivider.refine(vertices,faceVerts,vertsPerFace,channels=vertices)
+                refined = results(subdivider)
+                assert_same(refined,reference(level,mesh,scheme))
+                np.testing.assert_array_equal(subdivider.export_primvars()['channels'],refined['vertices'])
+
+    def test_uv_corners_stay(self):
+        # Every face is its own UV square, so with FVAR_LINEAR_CORNERS_ONLY all four corners of every island are pinned
+        vertices, faceVerts, vertsPerFace = mesh_arrays(test_topology.cube)
+        corners = np.array([[0,0],[1,0],[1,1],[0,1]],dtype=np.float32)
+        uvs = np.tile(corners,(len(vertsPerFace),1))
+        uv_indices = np.arange(len(faceVerts),dtype=np.int32)
+        for level in LEVELS:
+            with self.subTest(level=level):
+                subdivider = pysubdivision.Subdivider(level)
+                subdivider.refine(vertices,faceVerts,vertsPerFace,fvar_values=uvs,fvar_indices=uv_indices)
+                primvars = subdivider.export_primvars()
+                refined_uvs = primvars['fvar_values']
+                for corner in corners:
+                    self.assertEqual(np.count_nonzero(np.all(refined_uvs == corner,axis=1)),len(vertsPerFace))
+                self.assertTrue(np.all((refined_uvs >= 0) & (refined_uvs <= 1)))
+                self.assertEqual(len(primvars['fvar_indices']),len(results(subdivider)['faceVerts']))
+                self.assertTrue(np.all(primvars['fvar_indices'] < len(refined_uvs)))
+
+################ Limit surface ################
+class TestLimit(unittest.TestCase):
+    def test_ptex_faces(self):
+        # One per quad, one per corner of anything else
+        subdivider = pysubdivision.Subdivider()
+        for name in ('cube','ngons','ngons2','suzanne'):
+            with self.subTest(mesh=name):
+                vertsPerFace = mesh_arrays(MESHES[name])[2]
+                expected = np.cumsum([0] + [1 if size == 4 else size for size in vertsPerFace])
+                np.testing.assert_array_equal(subdivider.ptex_faces(vertsPerFace),expected)
+        # With Loop, one per triangle
+        subdivider.set_scheme('loop')
+        vertsPerFace = mesh_arrays(test_topology.triangles)[2]
+        np.testing.assert_array_equal(subdivider.ptex_faces(vertsPerFace),np.arange(len(vertsPerFace) + 1))
+
+    def test_matches_fine_refinement(self):
+        # The corners and centres of the cube's ptex faces are level 6 vertices, within a fraction of a percent of the limit
+        mesh = mesh_arrays(test_topology.cube)
+        uvs = np.array([[0,0],[1,0],[1,1],[0,1],[0.5,0.5]],dtype=np.float32)
+        n_ptex = len(mesh[2])
+        P = pysubdivision.Subdivider().evaluate_limit(*mesh,np.repeat(np.arange(n_ptex),len(uvs)),np.tile(uvs,(n_ptex,1)),derivatives=False)
+        fine = reference(6,mesh)['vertices']
+        distance = np.sqrt(((P[:,None,:] - fine[None,:,:]) ** 2).sum(axis=2)).min(axis=1)
+        self.assertLess(distance.max(),2e-3 * np.abs(fine).max())
+
+    def test_samples_off_the_mesh(self):
+        mesh = mesh_arrays(test_topology.cube)
+        n_ptex = len(mesh[2])
+        sample_faces = [0,0,0,0,-1,n_ptex,0]
+        sample_uvs = [[1.5,0.5],[0.5,-0.25],[np.nan,0.5],[0.5,np.nan],[0.5,0.5],[0.5,0.5],[0.5,0.5]]
+        P, dPdu, dPdv = pysubdivision.Subdivider().evaluate_limit(*mesh,sample_faces,sample_uvs)
+        for values in (P,dPdu,dPdv):
+            np.testing.assert_array_equal(values[:-1],0)
+        # ... while the one on the mesh is evaluated
+        self.assertGreater(np.abs(P[-1]).max(),0)
+
+################ Empty meshes ################
+EMPTY = (np.empty((0,3),dtype=np.float32),np.empty(0,dtype=np.int32),np.empty(0,dtype=np.int32))
+
+class TestEmpty(unittest.TestCase):
+    def test_refine(self):
+        for level in (0,) + LEVELS:
+            for stencils in (False,True):
+                with self.subTest(level=level,stencils=stencils):
+                    subdivider = pysubdivision.Subdivider(level)
+                    subdivider.use_stencils(stencils)
+                    subdivider.refine(*EMPTY)
+                    self.assertEqual(subdivider.counts(),(0,0,0))
+                    self.assertEqual(len(results(subdivider)['faceVerts']),0)
+
+    def test_refine_selective(self):
+        subdivider = pysubdivision.Subdivider(2)
+        subdivider.refine_selective(*EMPTY,face_levels=np.empty(0,dtype=np.int32))
+        self.assertEqual(subdivider.counts(),(0,0,0))
+
+    def test_refine_levels(self):
+        levels = pysubdivision.Subdivider(2).refine_levels(*EMPTY)
+        self.assertEqual(len(levels),3)
+        for level in levels:
+            self.assertEqual([len(level[key]) for key in ('vertices','edges','vertsPerFace','faceVerts')],[0,0,0,0])
+
+################ Faces and schemes ################
+def euler_characteristic(vertices,edges,vertsPerFace):
+    return len(vertices) - len(edges) + len(vertsPerFace)
+
+class TestSchemes(unittest.TestCase):
+    def test_level_zero_passes_through(self):
+        for name in ('ngons','ngons2','suzanne'):
+            with self.subTest(mesh=name):
+                vertices, faceVerts, vertsPerFace = mesh = mesh_arrays(MESHES[name])
+                refined = reference(0,mesh)
+                np.testing.assert_array_equal(refined['vertices'],vertices)
+                np.testing.assert_array_equal(refined['vertsPerFace'],vertsPerFace)
+                np.testing.assert_array_equal(refined['faceVerts'],faceVerts)
+
+    def test_bilinear(self):
+        # Level 1 is the control points, the face centroids and the edge midpoints, every face split into quads
+        for name, mesh in MESHES.items():
+            with self.subTest(mesh=name):
+                vertices, faceVerts, vertsPerFace = mesh_arrays(mesh)
+                refined = reference(1,(vertices,faceVerts,vertsPerFace),'bilinear')
+                edges = sorted(undirected(face_sides(vertsPerFace,faceVerts)))
+                expected = np.concatenate([
+                    vertices,
+                    [vertices[face].mean(axis=0) for face in pysubdivision.face_lists(vertsPerFace,faceVerts)],
+                    [(vertices[a] + vertices[b]) / 2 for a, b in edges]
+                ])
+                self.assertEqual(len(refined['vertices']),len(expected))
+                distance = np.sqrt(((expected[:,None,:] - refined['vertices'][None,:,:]) ** 2).sum(axis=2)).min(axis=1)
+                self.assertLess(distance.max(),tolerance(vertices))
+                self.assertEqual(len(refined['vertsPerFace']),vertsPerFace.sum())
+                self.assertTrue(np.all(refined['vertsPerFace'] == 4))
+                self.assertEqual(euler_characteristic(refined['vertices'],refined['edges'],refined['vertsPerFace']),
+                                 euler_characteristic(vertices,edges,vertsPerFace))
+
+    def test_loop(self):
+        vertices, faceVerts, vertsPerFace = mesh = mesh_arrays(test_topology.triangles)
+        edges = undirected(face_sides(vertsPerFace,faceVerts))
+        for level in LEVELS:
+            with self.subTest(level=level):
+                refined = reference(level,mesh,'loop')
+                self.assertEqual(len(refined['vertsPerFace']),len(vertsPerFace) * 4 ** level)
+                self.assertTrue(np.all(refined['vertsPerFace'] == 3))
+                self.assertEqual(len(refined['faceVerts']),3 * len(refined['vertsPerFace']))
+                self.assertEqual(euler_characteristic(refined['vertices'],refined['edges'],refined['vertsPerFace']),
+                                 euler_characteristic(vertices,edges,vertsPerFace))
+
+################ Native extension ################
+class TestExtension(unittest.TestCase):
+    def setUp(self):
+        if(pysubdivision._pysubdivision is None):
+            self.skipTest("the native extension isn't built (make extension)")
+
+    def test_matches_ctypes(self):
+        for name, level, scheme, mesh in cases():
+            with self.subTest(mesh=name,level=level,scheme=scheme):
+                native = pysubdivision._pysubdivision.Subdivider(level)
+                native.set_scheme(pysubdivision.SCHEMES[scheme])
+                native.refine(*mesh)
+                assert_same(native.results(),reference(level,mesh,scheme))
+
+    def test_without_init(self):
+        native = pysubdivision._pysubdivision.Subdivider.__new__(pysubdivision._pysubdivision.Subdivider)
+        self.assertEqual(len(native.results()['vertices']),0)
+
+    def test_any_numeric_dtype(self):
+        vertices, faceVerts, vertsPerFace = mesh = mesh_arrays(test_topology.suzanne)
+        refined = pysubdivision._pysubdivision.subdivide(2,vertices.astype(np.float64),faceVerts.astype(np.int64),vertsPerFace.tolist())
+        assert_same(refined,reference(2,mesh))
+
+    def test_bad_meshes(self):
+        vertices, faceVerts, vertsPerFace = mesh_arrays(test_topology.cube)
+        for name, faceVerts_in, vertsPerFace_in in (
+            ('index past the end',np.where(faceVerts == 0,len(vertices),faceVerts),vertsPerFace),
+            ('negative index',np.where(faceVerts == 0,-1,faceVerts),vertsPerFace),
+            ('two-vertex face',faceVerts[:2],[2]),
+            ('short faceVerts',faceVerts[:-1],vertsPerFace),
+        ):
+            with self.subTest(name):
+                with self.assertRaises(ValueError):
+                    pysubdivision._pysubdivision.subdivide(1,vertices,faceVerts_in,vertsPerFace_in)
+        # Loop takes triangles only
+        native = pysubdivision._pysubdivision.Subdivider(1)
+        native.set_scheme(pysubdivision.SCHEMES['loop'])
+        with self.assertRaises(ValueError):
+            native.refine(vertices,faceVerts,vertsPerFace)
+        with self.assertRaises(ValueError):
+            pysubdivision._pysubdivision.subdivide(1,"not a mesh",faceVerts,vertsPerFace)
+
+################ Stats ################
+class TestStats(unittest.TestCase):
+    def setUp(self):
+        if(not pysubdivision.Subdivider.stats_enabled()):
+            self.skipTest("library built with -DSUBDIVIDER_NO_STATS")
+
+    def test_counts_and_totals(self):
+        vertices, faceVerts, vertsPerFace = mesh = mesh_arrays(test_topology.suzanne)
+        subdivider = pysubdivision.Subdivider(2)
+        subdivider.refine(*mesh)
+        last, total = subdivider.stats()
+        self.assertEqual((last['verts_out'],last['edges_out'],last['faces_out']),subdivider.counts())
+        self.assertEqual((last['verts_in'],last['faces_in']),(len(vertices),len(vertsPerFace)))
+        self.assertEqual((last['calls'],last['cache_hits']),(1,0))
+        self.assertGreater(last['bytes_allocated'],0)
+
+        # A warm call: a cache hit, added to the totals
+        subdivider.refine(*mesh)
+        last, total = subdivider.stats()
+        self.assertEqual((last['calls'],last['cache_hits']),(1,1))
+        self.assertEqual((total['calls'],total['cache_hits']),(2,1))
+        self.assertEqual(total['verts_out'],2 * last['verts_out'])
+        self.assertGreaterEqual(total['total_ms'],last['total_ms'])
+
+        subdivider.reset_stats()
+        for stats in subdivider.stats():
+            self.assertEqual((stats['calls'],stats['cache_hits'],stats['verts_out'],stats['total_ms']),(0,0,0,0.0))
+
+    def test_other_refine_calls(self):
+        mesh = mesh_arrays(test_topology.cube)
+        subdivider = pysubdivision.Subdivider(2)
+        for refine in (lambda: subdivider.refine_levels(*mesh),lambda: subdivider.refine_selective(*mesh,mask=np.ones(len(mesh[2]),dtype=bool))):
+            refine()
+            refine()
+            last = subdivider.stats()[0]
+            self.assertEqual((last['verts_out'],last['edges_out'],last['faces_out']),subdivider.counts())
+            self.assertEqual((last['calls'],last['cache_hits']),(1,1))
+
+################ Precision ################
+class TestPrecision(unittest.TestCase):
+    def refine(self,level,scheme,mesh,stencils,precision):
+        subdivider = pysubdivision.Subdivider(level)
+        subdivider.set_scheme(scheme)
+        subdivider.use_stencils(stencils)
+        subdivider.set_precision(precision)
+        subdivider.refine(*mesh)
+        return results(subdivider), subdivider.export_vertices(np.float64)
+
+    def test_double_matches_float(self):
+        for name, level, scheme, mesh in cases():
+            for stencils in (False,True):
+                with self.subTest(mesh=name,level=level,scheme=scheme,stencils=stencils):
+                    single, _ = self.refine(level,scheme,mesh,stencils,'float')
+                    double, vertices = self.refine(level,scheme,mesh,stencils,'double')
+                    assert_same(double,single,tolerance(single['vertices']))
+                    np.testing.assert_allclose(vertices,single['vertices'],rtol=0,atol=tolerance(single['vertices']))
+
+    def test_avx2_matches_baseline(self):
+        try:
+            for name, level, scheme, mesh in cases():
+                for precision in ('float','double'):
+                    with self.subTest(mesh=name,level=level,scheme=scheme,precision=precision):
+                        pysubdivision.Subdivider.use_avx2(False)
+                        baseline, baseline_vertices = self.refine(level,scheme,mesh,True,precision)
+                        pysubdivision.Subdivider.use_avx2(True)
+                        wide, wide_vertices = self.refine(level,scheme,mesh,True,precision)
+                        # FMA rounds once where the baseline rounds twice
+                        assert_same(wide,baseline,tolerance(baseline['vertices']))
+                        np.testing.assert_allclose(wide_vertices,baseline_vertices,rtol=0,atol=tolerance(baseline['vertices']))
+        finally:
+            pysubdivision.Subdivider.use_avx2(True)
+
+################ OBJ files (executable) ################
+EXECUTABLE = os.path.join(os.path.dirname(os.path.abspath(__file__)),'..','..','ctypes_OpenSubdiv_executable')
+
+def obj_text(mesh,corner='{0}'):
+    # corner formats a face corner from its 1-based index (e.g. '{0}/{0}/{0}', or negative ones)
+    vertices, faceVerts, vertsPerFace = mesh
+    lines = ['# test mesh','o mesh']
+    lines += ['v %r %r %r' % tuple(float(x) for x in vertex) for vertex in vertices]
+    lines += ['vt 0.5 0.5','vn 0 0 1']
+    lines += ['f ' + ' '.join(corner.format(index + 1) for index in face) for face in pysubdivision.face_lists(vertsPerFace,faceVerts)]
+    return '\n'.join(lines) + '\n'
+
+def read_obj(path):
+    vertices, faces = [], []
+    with open(path) as file:
+        for line in file:
+            fields = line.split()
+            if(fields and fields[0] == 'v'):
+                vertices.append([float(x) for x in fields[1:4]])
+            elif(fields and fields[0] == 'f'):
+                faces.append([int(field) - 1 for field in fields[1:]])
+    return {
+        'vertices':np.array(vertices,dtype=np.float32).reshape(-1,3),
+        'vertsPerFace':np.array([len(face) for face in faces],dtype=np.int32),
+        'faceVerts':np.array(list(chain.from_iterable(faces)),dtype=np.int32)
+    }
+
+class TestObj(unittest.TestCase):
+    def setUp(self):
+        if(not os.path.exists(EXECUTABLE)):
+            self.skipTest("the executable isn't built (make executable)")
+        self.directory = tempfile.TemporaryDirectory()
+        self.addCleanup(self.directory.cleanup)
+        # An older build ignores -i / -o (or may not run here at all)
+        probe = os.path.join(self.directory.name,'probe.obj')
+        try:
+            self.subdivide(0,obj_text(mesh_arrays(test_topology.cube)),probe)
+        except (OSError,subprocess.CalledProcessError):
+            pass
+        if(not os.path.exists(probe)):
+            self.skipTest("the executable predates OBJ support or doesn't run here (make executable)")
+
+    def subdivide(self,level,text,output=None):
+        source = os.path.join(self.directory.name,'in.obj')
+        output = output or os.path.join(self.directory.name,'out.obj')
+        with open(source,'w') as file:
+            file.write(text)
+        subprocess.run([EXECUTABLE,'-l',str(level),'-i',source,'-o',output],check=True,stdout=subprocess.DEVNULL,timeout=60)
+        return read_obj(output)
+
+    def test_round_trip(self):
+        for name, mesh in MESHES.items():
+            with self.subTest(mesh=name):
+                vertices, faceVerts, vertsPerFace = mesh = mesh_arrays(mesh)
+                written = self.subdivide(0,obj_text(mesh))
+                np.testing.assert_allclose(written['vertices'],vertices,rtol=0,atol=1e-5)
+                np.testing.assert_array_equal(written['vertsPerFace'],vertsPerFace)
+                np.testing.assert_array_equal(written['faceVerts'],faceVerts)
+
+    def test_matches_subdivider(self):
+        for name, mesh in MESHES.items():
+            with self.subTest(mesh=name):
+                mesh = mesh_arrays(mesh)
+                written = self.subdivide(2,obj_text(mesh))
+                expected = reference(2,mesh)
+                assert_same(written,{key:expected[key] for key in written},1e-5 * max(1.0,float(np.abs(expected['vertices']).max())))
+
+    def test_corner_forms(self):
+        mesh = mesh_arrays(test_topology.ngons)
+        plain = self.subdivide(1,obj_text(mesh))
+        n_verts = len(mesh[0])
+        for corner in ('{0}/1/1','{0}//1','{0}/1','-%d' % (n_verts + 1)):
+            with self.subTest(corner=corner):
+                if(corner.startswith('-')):
+                    # Negative indices count back from the last vertex so far (every vertex comes before the faces)
+                    text = obj_text(mesh).splitlines()
+                    text = [line if not line.startswith('f ') else 'f ' + ' '.join(str(int(index) - n_verts - 1) for index in line.split()[1:]) for line in text]
+                    text = '\n'.join(text) + '\n'
+                else:
+                    text = obj_text(mesh,corner)
+                assert_same(self.subdivide(1,text),plain)
+
+################ Disk cache ################
+# disk_header layout (ctypes_subdivider.cpp): magic[8], format_version, byte_order, osd_version[32], key
+_FORMAT_VERSION_OFFSET = 8
+_KEY_OFFSET = 48
+
+class TestDiskCache(unittest.TestCase):
+    level = 2
+
+    def setUp(self):
+        self.directory = tempfile.TemporaryDirectory()
+        self.mesh = mesh_arrays(test_topology.suzanne)
+        self.expected = reference(self.level,self.mesh)
+
+    def tearDown(self):
+        self.directory.cleanup()
+
+    def files(self,directory=None):
+        directory = directory or self.directory.name
+        return sorted(name for name in os.listdir(directory) if name.endswith('.osdtopo'))
+
+    def subdivider(self,stencils=True,reorder=False,directory=None):
+        subdivider = pysubdivision.Subdivider(self.level)
+        subdivider.use_stencils(stencils)
+        subdivider.set_reorder(reorder)
+        subdivider.set_disk_cache(directory or self.directory.name)
+        return subdivider
+
+    def refine(self,subdivider,mesh=None):
+        subdivider.refine(*(mesh or self.mesh))
+        return results(subdivider)
+
+    def patch(self,offset,data):
+        path = os.path.join(self.directory.name,self.files()[0])
+        with open(path,'r+b') as file:
+            file.seek(offset)
+            file.write(data)
+
+    def test_round_trip(self):
+        writer = self.subdivider()
+        written = self.refine(writer)
+        self.assertFalse(writer.disk_cache_hit())
+        self.assertEqual(len(self.files()),1)
+        reader = self.subdivider(stencils=False)
+        read = self.refine(reader)
+        self.assertTrue(reader.disk_cache_hit())
+        assert_same(read,written)
+        assert_same(read,self.expected,tolerance(self.expected['vertices']))
+
+    def test_level_by_level_writes_nothing(self):
+        self.refine(self.subdivider(stencils=False))
+        self.assertEqual(self.files(),[])
+
+    def test_reordered_shares_the_file(self):
+        self.refine(self.subdivider())
+        reader = self.subdivider(reorder=True)
+        read = self.refine(reader)
+        self.assertTrue(reader.disk_cache_hit())
+        self.assertEqual(len(self.files()),1)
+        vertex_order, face_order = reader.export_order()
+        np.testing.assert_allclose(read['vertices'],self.expected['vertices'][vertex_order],rtol=0,atol=tolerance(self.expected['vertices']))
+
+    def test_other_format_version_is_ignored(self):
+        self.refine(self.subdivider())
+        self.patch(_FORMAT_VERSION_OFFSET,np.uint32(0xffff).tobytes())
+        reader = self.subdivider()
+        assert_same(self.refine(reader),self.expected,tolerance(self.expected['vertices']))
+        self.assertFalse(reader.disk_cache_hit())
+        # ... and replaced
+        again = self.subdivider()
+        self.refine(again)
+        self.assertTrue(again.disk_cache_hit())
+
+    def test_corrupt_file_is_ignored(self):
+        self.refine(self.subdivider())
+        path = os.path.join(self.directory.name,self.files()[0])
+        with open(path,'r+b') as file:
+            file.seek(-4,os.SEEK_END)
+            last = file.read(4)
+            file.seek(-4,os.SEEK_END)
+            file.write(bytes(b ^ 0xff for b in last))
+        reader = self.subdivider()
+        assert_same(self.refine(reader),self.expected,tolerance(self.expected['vertices']))
+        self.assertFalse(reader.disk_cache_hit())
+
+    def test_hash_collision_is_ignored(self):
+        # Same counts, other faces (every face wound the other way): A's file under B's name and key
+        vertices, faceVerts, vertsPerFace = self.mesh
+        flipped = np.concatenate([face[::-1] for face in pysubdivision.face_lists(vertsPerFace,faceVerts)]).astype(np.int32)
+        other = (vertices,flipped,vertsPerFace)
+        with tempfile.TemporaryDirectory() as elsewhere:
+            self.refine(self.subdivider(directory=elsewhere),other)
+            other_name = self.files(elsewhere)[0]
+        self.refine(self.subdivider())
+        os.rename(os.path.join(self.directory.name,self.files()[0]),os.path.join(self.directory.name,other_name))
+        self.patch(_KEY_OFFSET,np.uint64(int(other_name.split('.')[0],16)).tobytes())
+
+        reader = self.subdivider()
+        expected = reference(self.level,other)
+        assert_same(self.refine(reader,other),expected,tolerance(expected['vertices']))
+        self.assertFalse(reader.disk_cache_hit())
+
+    def test_empty_mesh(self):
+        empty = (np.empty((0,3),dtype=np.float32),np.empty(0,dtype=np.int32),np.empty(0,dtype=np.int32))
+        for i in range(2):
+            subdivider = self.subdivider()
+            self.refine(subdivider,empty)
+            self.assertEqual(subdivider.counts(),(0,0,0))
+            self.assertEqual(subdivider.disk_cache_hit(),i == 1)
+
+################ Incremental update ################
+class TestUpdate(unittest.TestCase):
+    def moved(self,vertices,indices):
+        positions = vertices[indices] + np.array([0.25,-0.5,0.125],dtype=vertices.dtype)
+        moved = vertices.copy()
+        moved[indices] = positions
+        return positions, moved
+
+    def test_matches_full_refine(self):
+        for name, level, scheme, mesh in cases():
+            with self.subTest(mesh=name,level=level,scheme=scheme):
+                vertices, faceVerts, vertsPerFace = mesh
+                indices = np.array([0,len(vertices) // 2,len(vertices) - 1],dtype=np.int32)
+                positions, moved = self.moved(vertices,indices)
+
+                subdivider = pysubdivision.Subdivider(level)
+                subdivider.set_scheme(scheme)
+                subdivider.use_stencils(True)
+                subdivider.refine(vertices,faceVerts,vertsPerFace)
+                previous = results(subdivider)['vertices']
+                updated = previous.copy()
+                dirty, (first, last) = subdivider.update_vertices(indices,positions,updated)
+
+                full = pysubdivision.Subdivider(level)
+                full.set_scheme(scheme)
+                full.use_stencils(True)
+                full.refine(moved,faceVerts,vertsPerFace)
+                expected = results(full)['vertices']
+                np.testing.assert_array_equal(updated,expected)
+                np.testing.assert_array_equal(results(subdivider)['vertices'],expected)
+                np.testing.assert_allclose(updated,reference(level,(moved,faceVerts,vertsPerFace),scheme)['vertices'],rtol=0,atol=tolerance(expected))
+
+                # Every vertex that changed is reported, sorted, within the range
+                changed = np.nonzero(np.any(previous != expected,axis=1))[0]
+                self.assertTrue(set(changed.tolist()) <= set(dirty.tolist()))
+                self.assertTrue(np.all(np.diff(dirty) > 0))
+                if(len(dirty) > 0):
+                    self.assertEqual((first,last),(dirty[0],dirty[-1] + 1))
+
+    def test_double_precision(self):
+        vertices, faceVerts, vertsPerFace = mesh_arrays(test_topology.suzanne)
+        indices = np.array([3,7],dtype=np.int32)
+        positions, moved = self.moved(vertices,indices)
+        subdivider = pysubdivision.Subdivider(2)
+        subdivider.use_stencils(True)
+        subdivider.set_precision('double')
+        subdivider.refine(vertices,faceVerts,vertsPerFace)
+        updated = subdivider.export_vertices(np.float64)
+        subdivider.update_vertices(indices,positions,updated)
+
+        full = pysubdivision.Subdivider(2)
+        full.use_stencils(True)
+        full.set_precision('double')
+        full.refine(moved,faceVerts,vertsPerFace)
+        np.testing.assert_array_equal(updated,full.export_vertices(np.float64))
+
+    def test_needs_stencils(self):
+        vertices, faceVerts, vertsPerFace = mesh_arrays(test_topology.cube)
+        subdivider = pysubdivision.Subdivider(2)
+        self.assertIsNone(subdivider.update_vertices([0],[[0,0,0]]))
+        subdivider.refine(vertices,faceVerts,vertsPerFace)
+        self.assertIsNone(subdivider.update_vertices([0],[[0,0,0]]))
+
+################ Async ################
+class TestAsync(unittest.TestCase):
+    def test_result_matches_refine(self):
+        mesh = mesh_arrays(test_topology.suzanne)
+        subdivider = pysubdivision.Subdivider(2)
+        future = subdivider.submit(*mesh)
+        result = future.result(timeout=60)
+        self.assertTrue(future.done())
+        self.assertFalse(future.cancelled())
+        expected = reference(2,mesh)
+        assert_same({key:result[key] for key in expected},expected)
+        # ... and it became the subdivider's results
+        assert_same(results(subdivider),expected)
+
+    def test_cancel_pending(self):
+        # Jobs run one at a time in order, so the last of a queue is still pending when it's cancelled
+        mesh = mesh_arrays(test_topology.suzanne)
+        subdivider = pysubdivision.Subdivider(3)
+        queue = [subdivider.submit(*mesh,supersede=False) for i in range(4)]
+        self.assertTrue(queue[-1].cancel())
+        with self.assertRaises(concurrent.futures.CancelledError):
+            queue[-1].result(timeout=60)
+        self.assertTrue(queue[-1].cancelled())
+        expected = reference(3,mesh)
+        for future in queue[:-1]:
+            np.testing.assert_array_equal(future.result(timeout=60)['vertices'],expected['vertices'])
+
+    def test_supersede(self):
+        vertices, faceVerts, vertsPerFace = mesh_arrays(test_topology.suzanne)
+        subdivider = pysubdivision.Subdivider(2)
+        futures = [subdivider.submit(vertices + i,faceVerts,vertsPerFace) for i in range(5)]
+        np.testing.assert_array_equal(futures[-1].result(timeout=60)['vertices'],reference(2,(vertices + 4,faceVerts,vertsPerFace))['vertices'])
+        for i, future in enumerate(futures[:-1]):
+            # Either it finished before the next one came in, or it was cancelled by it
+            try:
+                result = future.result(timeout=60)
+            except concurrent.futures.CancelledError:
+                continue
+            np.testing.assert_array_equal(result['vertices'],reference(2,(vertices + i,faceVerts,vertsPerFace))['vertices'])
+
+################ Selective refinement ################
+class TestSelective(unittest.TestCase):
+    def unshared_sides(self,vertsPerFace,faceVerts):
+        # Sides without the opposite side of a neighbour: boundary edges, or cracks
+        sides = face_sides(vertsPerFace,faceVerts)
+        present = set(sides)
+        return [(a,b) for a, b in sides if (b,a) not in present]
+
+    def check_watertight(self,mesh,face_levels):
+        vertices, faceVerts, vertsPerFace = mesh
+        subdivider = pysubdivision.Subdivider(3)
+        subdivider.refine_selective(vertices,faceVerts,vertsPerFace,face_levels=face_levels)
+        refined = results(subdivider)
+        self.assertEqual(len(self.unshared_sides(refined['vertsPerFace'],refined['faceVerts'])),0)
+        # Every side appears once (the faces are consistently oriented, no edge is used by three faces)
+        sides = face_sides(refined['vertsPerFace'],refined['faceVerts'])
+        self.assertEqual(len(set(sides)),len(sides))
+        self.assertTrue(np.all(refined['faceVerts'] < len(refined['vertices'])))
+
+    def test_closed_mesh_stays_closed(self):
+        mesh = mesh_arrays(test_topology.cube)
+        n_faces = len(mesh[2])
+        self.check_watertight(mesh,np.zeros(n_faces,dtype=np.int32))
+        self.check_watertight(mesh,np.arange(n_faces,dtype=np.int32) % 4)
+        self.check_watertight(mesh,np.full(n_faces,3,dtype=np.int32))
+        for face in range(n_faces):
+            with self.subTest(face=face):
+                face_levels = np.zeros(n_faces,dtype=np.int32)
+                face_levels[face] = 3
+                self.check_watertight(mesh,face_levels)
+
+    def test_uniform_levels_match_refine(self):
+        mesh = mesh_arrays(test_topology.cube)
+        for level in (0,) + LEVELS:
+            with self.subTest(level=level):
+                subdivider = pysubdivision.Subdivider(3)
+                subdivider.refine_selective(*mesh,face_levels=np.full(len(mesh[2]),level,dtype=np.int32))
+                refined = results(subdivider)
+                expected = reference(level,mesh)
+                self.assertEqual(len(refined['vertices']),len(expected['vertices']))
+                self.assertEqual(len(refined['vertsPerFace']),len(expected['vertsPerFace']))
+
+    def test_mask(self):
+        vertices, faceVerts, vertsPerFace = mesh_arrays(test_topology.cube)
+        mask = np.zeros(len(vertsPerFace),dtype=bool)
+        mask[::2] = True
+        subdivider = pysubdivision.Subdivider(2)
+        subdivider.refine_selective(vertices,faceVerts,vertsPerFace,mask=mask)
+        refined = results(subdivider)
+        self.assertEqual(len(self.unshared_sides(refined['vertsPerFace'],refined['faceVerts'])),0)
+
+################ All levels ################
+class TestLevels(unittest.TestCase):
+    def test_every_level_matches_refine(self):
+        for name, level, scheme, mesh in cases():
+            with self.subTest(mesh=name,level=level,scheme=scheme):
+                subdivider = pysubdivision.Subdivider(level)
+                subdivider.set_scheme(scheme)
+                levels = subdivider.refine_levels(*mesh)
+                expected = [reference(l,mesh,scheme) for l in range(level + 1)]
+                self.assertEqual(len(levels),level + 1)
+                for refined, plain in zip(levels,expected):
+                    # refine lists level 0's edges in the input's order, the refiner in its own: the same edges
+                    self.assertEqual(undirected(map(tuple,refined['edges'])),undirected(map(tuple,plain['edges'])))
+                    self.assertEqual(len(refined['edges']),len(plain['edges']))
+                    assert_same({key:refined[key] for key in ('vertices','vertsPerFace','faceVerts')},{key:plain[key] for key in ('vertices','vertsPerFace','faceVerts')})
+                # The offsets delimit each level in the concatenated buffers
+                exported = subdivider.export_levels()
+                for key, offsets in (('vertices','vert_offsets'),('edges','edge_offsets'),('vertsPerFace','face_offsets'),('faceVerts','face_vert_offsets')):
+                    self.assertEqual(len(exported[offsets]),level + 2)
+                    self.assertEqual(exported[offsets][0],0)
+                    self.assertEqual(exported[offsets][-1],len(exported[key]))
+                    np.testing.assert_array_equal(np.diff(exported[offsets]),[len(plain[key]) for plain in expected])
+
+################ Reordering ################
+class TestReorder(unittest.TestCase):
+    def test_permutation_of_plain_results(self):
+        for name, level, scheme, mesh in cases():
+            for stencils in (False,True):
+                with self.subTest(mesh=name,level=level,scheme=scheme,stencils=stencils):
+                    expected = reference(level,mesh,scheme)
+                    subdivider = pysubdivision.Subdivider(level)
+                    subdivider.set_scheme(scheme)
+                    subdivider.use_stencils(stencils)
+                    subdivider.set_reorder(True)
+                    subdivider.refine(*mesh)
+                    actual = results(subdivider)
+                    vertex_order, face_order = subdivider.export_order()
+
+                    # Permutations
+                    np.testing.assert_array_equal(np.sort(vertex_order),np.arange(len(expected['vertices'])))
+                    np.testing.assert_array_equal(np.sort(face_order),np.arange(len(expected['vertsPerFace'])))
+                    # Result vertex i is plain vertex vertex_order[i]
+                    if(stencils):
+                        np.testing.assert_allclose(actual['vertices'],expected['vertices'][vertex_order],rtol=0,atol=tolerance(expected['vertices']))
+                    else:
+                        np.testing.assert_array_equal(actual['vertices'],expected['vertices'][vertex_order])
+                    # Result face i is plain face face_order[i], its vertices renumbered
+                    expected_faces = pysubdivision.face_lists(expected['vertsPerFace'],expected['faceVerts'])
+                    actual_faces = pysubdivision.face_lists(actual['vertsPerFace'],actual['faceVerts'])
+                    self.assertEqual([vertex_order[face].tolist() for face in map(np.array,actual_faces)],[expected_faces[f] for f in face_order])
+                    self.assertEqual({tuple(sorted(vertex_order[edge])) for edge in actual['edges']},undirected(map(tuple,expected['edges'])))
+
+    def test_identity_without_reorder(self):
+        mesh = mesh_arrays(test_topology.cube)
+        subdivider = pysubdivision.Subdivider(2)
+        subdivider.refine(*mesh)
+        vertex_order, face_order = subdivider.export_order()
+        np.testing.assert_array_equal(vertex_order,np.arange(len(vertex_order)))
+        np.testing.assert_array_equal(face_order,np.arange(len(face_order)))
+
+################ Worker pool ################
+def shared_memory_segments():
+    return set(os.listdir('/dev/shm')) if os.path.isdir('/dev/shm') else set()
+
+class TestWorker(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls):
+        from pyOpenSubdiv import worker
+        if(worker._posixshmem is None or not os.path.exists(worker.WORKER_EXECUTABLE)):
+            raise unittest.SkipTest("the worker isn't built (make worker)")
+        cls.worker = worker
+        cls.directory = tempfile.TemporaryDirectory()
+        cls.socket_path = os.path.join(cls.directory.name,'pool.sock')
+        cls.pool = worker.start_pool(2,cls.socket_path)
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.pool.terminate()
+        cls.pool.wait(timeout=30)
+        cls.directory.cleanup()
+
+    def subdivider(self,level):
+        return self.worker.WorkerSubdivider(level,socket_path=self.socket_path)
+
+    def workers(self):
+        # The pool's processes, from /proc
+        children = []
+        for entry in os.listdir('/proc'):
+            try:
+                with open(os.path.join('/proc',entry,'stat')) as file:
+                    stat = file.read()
+            except (OSError,ValueError):
+                continue
+            if(entry.isdigit() and int(stat.rsplit(')',1)[1].split()[1]) == self.pool.pid):
+                children.append(int(entry))
+        return sorted(children)
+
+    def test_matches_subdivider(self):
+        for name, level, scheme, mesh in cases():
+            for stencils in (False,True):
+                with self.subTest(mesh=name,level=level,scheme=scheme,stencils=stencils):
+                    outputs = []
+                    for subdivider in (self.subdivider(level),pysubdivision.Subdivider(level)):
+                        subdivider.set_scheme(scheme)
+                        subdivider.use_stencils(stencils)
+                        subdivider.refine(*mesh)
+                        outputs.append(results(subdivider))
+                    assert_same(outputs[0],outputs[1])
+
+    def test_crashed_worker_is_replaced(self):
+        if(not os.path.isdir('/proc')):
+            self.skipTest("needs /proc to find the workers")
+        mesh = mesh_arrays(test_topology.suzanne)
+        expected = reference(2,mesh)
+        workers = self.workers()
+        self.assertEqual(len(workers),2)
+        os.kill(workers[0],signal.SIGKILL)
+        deadline = time.monotonic() + 30
+        while(len(self.workers()) != 2 or workers[0] in self.workers()):
+            self.assertLess(time.monotonic(),deadline,"the pool didn't restart the worker")
+            time.sleep(0.05)
+        # Whichever worker takes them, the jobs come back right
+        for i in range(4):
+            subdivider = self.subdivider(2)
+            subdivider.refine(*mesh)
+            assert_same(results(subdivider),expected)
+
+    def test_no_segments_left(self):
+        before = shared_memory_segments()
+        subdivider = self.subdivider(2)
+        subdivider.refine(*mesh_arrays(test_topology.cube))
+        subdivider.close()
+        self.assertEqual({name for name in shared_memory_segments() - before if name.startswith('pyOpenSubdiv')},set())
+
+class TestPoolRunning(unittest.TestCase):
+    def test_silent_listener(self):
+        # Something that accepts but never answers (a pool with every worker busy) counts as running
+        from pyOpenSubdiv import worker
+        with tempfile.TemporaryDirectory() as directory:
+            path = os.path.join(directory,'silent.sock')
+            with socket.socket(socket.AF_UNIX,socket.SOCK_STREAM) as listener:
+                listener.bind(path)
+                listener.listen(1)
+                self.assertTrue(worker.pool_running(path,timeout=0.2))
+            self.assertFalse(worker.pool_running(path,timeout=0.2))
+
+if __name__ == '__main__':
+    unittest.main()
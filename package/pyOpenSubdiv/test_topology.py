@@ -28,6 +28,40 @@ def convert_to_cpp(topology):
     g_vertIndices = ',\n'.join([faceVerts for faceVerts in g_vertIndices])    
     print(f'static int g_vertIndices[{sum(vertsPerFace)}] = {{\n{g_vertIndices} }};')
 
+def write_cpp_header(path,topologies):
+    # All the topologies in one header (benchmark_meshes.h, used by benchmark.cpp), 
+    # e.g. write_cpp_header('benchmark_meshes.h',{'cube':cube,'suzanne':suzanne,...}) 
+    lines = [
+        '// Generated by pyOpenSubdiv/test_topology.py (write_cpp_header), do not edit.',
+        '#pragma once',
+        '',
+        'struct benchmark_mesh {',
+        '    char const* name;',
+        '    int n_verts;',
+        '    int n_faces;',
+        '    float (*verts)[3];',
+        '    int* faceVerts;',
+        '    int* vertsPerFace;',
+        '};',
+        ''
+    ]
+    for name, topology in topologies.items():
+        verts = topology['verts']
+        faces = topology['faces']
+        faceVerts = list(chain.from_iterable(faces))
+        vertsPerFace = [len(face) for face in faces]
+        g_verts = ',\n'.join([f'    {{{float(vert[0])!r}f, {float(vert[1])!r}f, {float(vert[2])!r}f}}' for vert in verts])
+        lines.append(f'static float {name}_verts[{len(verts)}][3] = {{\n{g_verts} }};')
+        lines.append(f'static int {name}_vertsPerFace[{len(vertsPerFace)}] = {{ {", ".join(map(str,vertsPerFace))} }};')
+        lines.append(f'static int {name}_faceVerts[{len(faceVerts)}] = {{\n    {", ".join(map(str,faceVerts))} }};')
+        lines.append('')
+
+    entries = ',\n'.join([f'    {{ "{name}", {len(topology["verts"])}, {len(topology["faces"])}, {name}_verts, {name}_faceVerts, {name}_vertsPerFace }}' for name, topology in topologies.items()])
+    lines.append(f'static benchmark_mesh const benchmark_meshes[{len(topologies)}] = {{\n{entries}\n}};')
+    lines.append('')
+    with open(path,'w') as file:
+        file.write('\n'.join(lines))
+
 ################################
 
 cube_verts = [
@@ -0,0 +1,245 @@
+import mmap
+import os
+import socket
+import struct
+import subprocess
+import threading
+import time
+from concurrent.futures import ThreadPoolExecutor
+
+import numpy as np
+
+# Out-of-process backend: refinement runs in a pool of subdivision_worker processes (subdivision_worker.cpp, make worker)
+# rather than in this one, so a crash on bad input or a refinement that runs out of memory takes down a worker
+# (the pool restarts it) instead of Blender, and big jobs spread over processes.
+# Meshes go both ways through POSIX shared memory, results come back as numpy views of it.
+# This module doesn't load ctypes_OpenSubdiv at all. POSIX only (Linux, macOS).
+try:
+    import _posixshmem
+except ImportError:
+    _posixshmem = None
+
+WORKER_EXECUTABLE = os.path.join(os.path.dirname(__file__),'clib','subdivision_worker')
+
+# Same as pysubdivision.SCHEMES (kept here so this module doesn't need the library)
+SCHEMES = {'bilinear':0,'catmark':1,'loop':2}
+
+################ Protocol ################
+# Mirrors struct worker_request / worker_reply in subdivision_worker.cpp (field order and sizes matter)
+_MAGIC = 0x4f534457
+_PROTOCOL_VERSION = 1
+_OP_REFINE = 1
+_OP_PING = 2
+# magic, version, op, maxlevel, scheme, threads, reorder, use_stencils, n_verts, n_faces, n_faceVerts, reserved, segment
+_REQUEST = struct.Struct('=IIiiiiiiiiii64s')
+# magic, status, nn_verts, nn_edges, nn_faces, nn_face_verts, cache_hit, pid, segment, message
+_REPLY = struct.Struct('=Iiiiiiii64s128s')
+
+class WorkerError(RuntimeError):
+    # The worker turned the job down (bad mesh, out of memory) or died on it. The pool carries on either way.
+    pass
+
+def default_socket_path():
+    # Same default as subdivision_worker
+    runtime_dir = os.environ.get('XDG_RUNTIME_DIR')
+    if(runtime_dir):
+        return os.path.join(runtime_dir,'pyOpenSubdiv.sock')
+    return '/tmp/pyOpenSubdiv-%d.sock' % os.getuid()
+
+def _connect(socket_path,timeout=None):
+    connection = socket.socket(socket.AF_UNIX,socket.SOCK_STREAM)
+    connection.settimeout(timeout)
+    try:
+        connection.connect(socket_path)
+    except OSError:
+        connection.close()
+        raise
+    return connection
+
+def _receive(connection,size):
+    data = bytearray()
+    while(len(data) < size):
+        chunk = connection.recv(size - len(data))
+        if(not chunk):
+            raise WorkerError("the worker died on this job (it has been restarted)")
+        data += chunk
+    return bytes(data)
+
+def _unlink_segment(name):
+    # Both ends unlink the segments (see Protocol in subdivision_worker.cpp), whichever comes second finds nothing
+    try:
+        _posixshmem.shm_unlink(name)
+    except FileNotFoundError:
+        pass
+
+def _map_segment(name,size):
+    # Maps a POSIX shared memory segment (by its shm_open name), read only
+    fd = _posixshmem.shm_open(name,os.O_RDONLY,mode=0o600)
+    try:
+        return mmap.mmap(fd,size,prot=mmap.PROT_READ)
+    finally:
+        os.close(fd)
+
+def pool_running(socket_path=None,timeout=1.0):
+    # A pool whose workers are all busy only answers the ping once one is free, so no answer within timeout
+    # (seconds) still counts as running: something is listening on the socket.
+    try:
+        with _connect(socket_path or default_socket_path(),timeout) as connection:
+            connection.sendall(_REQUEST.pack(_MAGIC,_PROTOCOL_VERSION,_OP_PING,0,0,0,0,0,0,0,0,0,b''))
+            _receive(connection,_REPLY.size)
+    except socket.timeout:
+        return True
+    except (OSError,WorkerError):
+        return False
+    return True
+
+def start_pool(workers=0,socket_path=None,cache_size=8,disk_cache=None,timeout=10.0):
+    # Starts a subdivision_worker pool in the background (workers=0: one per core), unless one is already serving
+    # socket_path. The pool outlives this process and is shared by every client on the machine using that socket;
+    # disk_cache (a directory) lets its workers share refined topologies. Returns the Popen, or None if one was running.
+    socket_path = socket_path or default_socket_path()
+    if(pool_running(socket_path)):
+        return None
+    arguments = [WORKER_EXECUTABLE,'-s',socket_path,'-n',str(workers),'-c',str(cache_size)]
+    if(disk_cache):
+        arguments += ['-d',disk_cache]
+    process = subprocess.Popen(arguments,stdin=subprocess.DEVNULL,start_new_session=True)
+    deadline = time.monotonic() + timeout
+    while(not pool_running(socket_path)):
+        if(process.poll() is not None or time.monotonic() > deadline):
+            raise WorkerError("subdivision_worker didn't come up on %s" % socket_path)
+        time.sleep(0.01)
+    return process
+
+class WorkerSubdivider:
+    """
+    Drop-in for Subdivider (settings, set_scheme, set_reorder, use_stencils, refine, counts and the exports)
+    that refines in a subdivision_worker pool (see start_pool). Every refine is one job on one connection,
+    taken by whichever worker is free, so separate instances (threads, processes) refine in parallel.
+    Positions only: no primvars, double precision or incremental updates.
+    """
+    def __init__(self,subdivision_level=0,verbose=False,threads=0,socket_path=None):
+        if(_posixshmem is None):
+            raise WorkerError("the worker backend needs POSIX shared memory")
+        self._socket_path = socket_path or default_socket_path()
+        self._scheme = SCHEMES['catmark']
+        self._reorder = False
+        self._stencils = False
+        self._jobs = 0
+        self._results = None
+        self.cache_hit = False
+        self.settings(subdivision_level,verbose,threads)
+
+    def close(self):
+        # Drops the results (their shared memory goes once nothing else views it)
+        self._results = None
+
+    def settings(self,subdivision_level,verbose=False,threads=0):
+        # verbose is ignored (a worker has nowhere to print to). 
+        # threads is capped at the worker's share of the cores (cores / workers), 0 takes all of that share.
+        self._level = max(int(subdivision_level),0)
+        self._threads = threads
+
+    def set_scheme(self,scheme):
+        self._scheme = SCHEMES[scheme]
+
+    def set_reorder(self,enabled):
+        self._reorder = bool(enabled)
+
+    def use_stencils(self,enabled):
+        self._stencils = bool(enabled)
+
+    def refine(self,vertices,faceVerts,vertsPerFace):
+        vertices = np.asarray(vertices,dtype=np.float32).reshape(-1,3)
+        faceVerts = np.asarray(faceVerts,dtype=np.int32).reshape(-1)
+        vertsPerFace = np.asarray(vertsPerFace,dtype=np.int32).reshape(-1)
+        n_verts, n_faces, n_faceVerts = len(vertices), len(vertsPerFace), len(faceVerts)
+
+        # -------- Mesh into shared memory (straight into place, one pass) --------
+        # The segment only has to outlive the job: the worker unlinks it once it has mapped it, and so does this once the
+        # reply is in (or the job failed). 
+        self._jobs += 1
+        segment = '/pyOpenSubdiv-client-%d-%d-%d' % (os.getpid(),id(self),self._jobs)
+        size = max(4 * (3 * n_verts + n_faceVerts + n_faces),8)
+        fd = _posixshmem.shm_open(segment,os.O_CREAT | os.O_EXCL | os.O_RDWR,mode=0o600)
+        try:
+            os.ftruncate(fd,size)
+            with mmap.mmap(fd,size) as mapping:
+                np.ndarray((n_verts,3),dtype=np.float32,buffer=mapping)[:] = vertices
+                np.ndarray(n_faceVerts,dtype=np.int32,buffer=mapping,offset=12 * n_verts)[:] = faceVerts
+                np.ndarray(n_faces,dtype=np.int32,buffer=mapping,offset=4 * (3 * n_verts + n_faceVerts))[:] = vertsPerFace
+            os.close(fd)
+            fd = -1
+
+            # -------- Job --------
+            request = _REQUEST.pack(_MAGIC,_PROTOCOL_VERSION,_OP_REFINE,self._level,self._scheme,self._threads,
+                int(self._reorder),int(self._stencils),n_verts,n_faces,n_faceVerts,0,segment.encode())
+            try:
+                connection = _connect(self._socket_path)
+            except OSError as error:
+                raise WorkerError("no subdivision_worker pool on %s (%s)" % (self._socket_path,error))
+            # The connection stays open until the results are mapped: the worker unlinks them when it closes
+            with connection:
+                connection.sendall(request)
+                reply = _REPLY.unpack(_receive(connection,_REPLY.size))
+                magic, status, nn_verts, nn_edges, nn_faces, nn_face_verts, cache_hit, pid, name, message = reply
+                if(status != 0):
+                    raise WorkerError("worker %d: %s" % (pid,message.split(b'\0',1)[0].decode(errors='replace')))
+
+                # -------- Results, mapped (the segment goes away once nothing views it anymore) --------
+                name = name.split(b'\0',1)[0].decode()
+                output_size = max(4 * (3 * nn_verts + 2 * nn_edges + nn_faces + nn_face_verts),8)
+                try:
+                    results = _map_segment(name,output_size)
+                finally:
+                    _unlink_segment(name)
+        finally:
+            if(fd >= 0):
+                os.close(fd)
+            _unlink_segment(segment)
+        offsets = np.cumsum([0,12 * nn_verts,8 * nn_edges,4 * nn_faces])
+        self._results = {
+            'vertices' : np.frombuffer(results,dtype=np.float32,count=3 * nn_verts,offset=offsets[0]).reshape(-1,3),
+            'edges' : np.frombuffer(results,dtype=np.int32,count=2 * nn_edges,offset=offsets[1]).reshape(-1,2),
+            'vertsPerFace' : np.frombuffer(results,dtype=np.int32,count=nn_faces,offset=offsets[2]),
+            'faces' : np.frombuffer(results,dtype=np.int32,count=nn_face_verts,offset=offsets[3])
+        }
+        self.cache_hit = bool(cache_hit)
+
+    #### Results ####
+    def _result(self,name):
+        if(self._results is None):
+            raise WorkerError("nothing refined yet")
+        return self._results[name]
+
+    def counts(self):
+        return len(self._result('vertices')), len(self._result('edges')), len(self._result('vertsPerFace'))
+
+    def view_results(self):
+        # Read-only numpy views of the shared memory the worker wrote the results into (no copy).
+        # Unlike Subdivider.view_results they stay valid after the next refine.
+        self._result('vertices')
+        return dict(self._results)
+
+    def export_mesh(self,vertices,edges,faces):
+        for target, name in ((vertices,'vertices'),(edges,'edges'),(faces,'faces')):
+            if(target is not None):
+                target.reshape(-1)[:] = self._result(name).reshape(-1)
+
+    def export_vertices(self,dtype=np.float32):
+        return self._result('vertices').astype(dtype)
+
+    def export_faces(self):
+        return self._result('vertsPerFace').copy(), self._result('faces').copy()
+
+def refine_many(subdivision_level,meshes,socket_path=None,jobs=0):
+    # meshes: list of (vertices, faceVerts, vertsPerFace). They go to the pool as separate jobs, jobs at a time
+    # (0: one per core), so they refine in as many worker processes at once. Returns view_results() of every mesh.
+    local = threading.local()
+    def refine(mesh):
+        if(not hasattr(local,'subdivider')):
+            local.subdivider = WorkerSubdivider(subdivision_level,socket_path=socket_path)
+        local.subdivider.refine(*mesh)
+        return local.subdivider.view_results()
+    with ThreadPoolExecutor(max_workers=jobs or os.cpu_count()) as executor:
+        return list(executor.map(refine,meshes))
@@ -29,7 +29,7 @@ setup(
     long_description = LONG_DESCRIPTION,
     packages = find_packages(),
     include_package_data=True,
-    package_data={f'{NAME}.clib':['*.so','*.dll']}, # https://stackoverflow.com/questions/70334648/how-to-correctly-install-data-files-with-setup-py
+    package_data={f'{NAME}.clib':['*.so','*.dll','*.pyd','subdivision_worker']}, # https://stackoverflow.com/questions/70334648/how-to-correctly-install-data-files-with-setup-py
     install_requires = ["numpy"],    
     keywords = ['subdivision','opensubdiv','Catmull-Clark','hard-surface'],
     classifiers= [
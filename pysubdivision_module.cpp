@@ -0,0 +1,311 @@
+// Native python extension module (pyOpenSubdiv.clib._pysubdivision), built on the same engine as ctypes_OpenSubdiv.so.
+// Takes anything numpy can view (numpy arrays, array.array, memoryviews, Blender foreach_get buffers, ...)
+// without copying when the dtype already matches (float32 vertices, int32 indices), and hands results back as numpy arrays.
+// No argtypes, no ctypes pointers, and the GIL is released while refining.
+// Build with `make extension`.
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#define NPY_NO_DEPRECATED_API NPY_1_7_API_VERSION
+#include <numpy/arrayobject.h>
+
+#define SUBDIVIDER_NO_MAIN
+#include "ctypes_subdivider.cpp"
+
+#include <new>
+#include <string>
+
+//---------------- Input ----------------
+// C-contiguous float32 / int32 view of any array-like.
+// Zero-copy if it already is one (numpy goes through the buffer protocol for non-numpy objects), converted otherwise,
+// from any numeric dtype (float64 vertices, int64 indices), like np.asarray(..., dtype=...) on the ctypes path.
+// A failed conversion keeps numpy's own exception.
+static PyArrayObject* as_array(PyObject* obj, int type) {
+    return (PyArrayObject*)PyArray_FROMANY(obj, type, 0, 0, NPY_ARRAY_IN_ARRAY | NPY_ARRAY_FORCECAST);
+}
+
+// Holds the three topology arrays of a refine call
+struct mesh_arrays {
+    mesh_arrays() : vertices(NULL), faceVerts(NULL), vertsPerFace(NULL) { }
+    ~mesh_arrays() {
+        Py_XDECREF(vertices);
+        Py_XDECREF(faceVerts);
+        Py_XDECREF(vertsPerFace);
+    }
+
+    // Same checks as the worker's valid_mesh, OpenSubdiv reads out of bounds on anything else
+    bool acquire(PyObject* py_vertices, PyObject* py_faceVerts, PyObject* py_vertsPerFace, int scheme) {
+        vertices = as_array(py_vertices, NPY_FLOAT32);
+        faceVerts = vertices ? as_array(py_faceVerts, NPY_INT32) : NULL;
+        vertsPerFace = faceVerts ? as_array(py_vertsPerFace, NPY_INT32) : NULL;
+        if (vertsPerFace == NULL) {
+            return false;
+        }
+        if (PyArray_SIZE(vertices) % 3 != 0) {
+            PyErr_SetString(PyExc_ValueError, "vertices: expected 3 floats per vertex");
+            return false;
+        }
+        long long n_faceVerts = 0;
+        int const* sizes = (int const*)PyArray_DATA(vertsPerFace);
+        for (npy_intp i = 0; i < PyArray_SIZE(vertsPerFace); i++) {
+            if (sizes[i] < 3 || (scheme == Sdc::SCHEME_LOOP && sizes[i] != 3)) {
+                PyErr_Format(PyExc_ValueError, "vertsPerFace: face %zd has %d vertices", (Py_ssize_t)i, sizes[i]);
+                return false;
+            }
+            n_faceVerts += sizes[i];
+        }
+        if (n_faceVerts != PyArray_SIZE(faceVerts)) {
+            PyErr_SetString(PyExc_ValueError, "faceVerts: expected sum(vertsPerFace) indices");
+            return false;
+        }
+        int const* indices = (int const*)PyArray_DATA(faceVerts);
+        for (npy_intp i = 0; i < PyArray_SIZE(faceVerts); i++) {
+            if (indices[i] < 0 || indices[i] >= n_verts()) {
+                PyErr_Format(PyExc_ValueError, "faceVerts: vertex %d out of range", indices[i]);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    int n_verts() const { return (int)(PyArray_SIZE(vertices) / 3); }
+    int n_faces() const { return (int)PyArray_SIZE(vertsPerFace); }
+
+    PyArrayObject* vertices;
+    PyArrayObject* faceVerts;
+    PyArrayObject* vertsPerFace;
+};
+
+//---------------- Engine calls ----------------
+// Runs call without the GIL. The engine throws (std::bad_alloc, OpenSubdiv errors) and an exception can't
+// unwind through the interpreter, so it's caught here and raised as MemoryError / RuntimeError once the GIL is back.
+template <typename F>
+static bool without_gil(F call) {
+    bool no_memory = false;
+    std::string error;
+    Py_BEGIN_ALLOW_THREADS
+    try {
+        call();
+    } catch (std::bad_alloc const&) {
+        no_memory = true;
+    } catch (std::exception const& e) {
+        error = e.what();
+        if (error.empty()) {
+            error = "refinement failed";
+        }
+    }
+    Py_END_ALLOW_THREADS
+    if (no_memory) {
+        PyErr_NoMemory();
+        return false;
+    }
+    if (!error.empty()) {
+        PyErr_SetString(PyExc_RuntimeError, error.c_str());
+        return false;
+    }
+    return true;
+}
+
+//---------------- Output ----------------
+// The last refinement as a dict of numpy arrays (faces in CSR form, like Subdivider.export_faces)
+static PyObject* results(subdivider& engine) {
+    npy_intp vertices_shape[2] = { engine.nn_verts, 3 };
+    npy_intp edges_shape[2] = { engine.nn_edges, 2 };
+    npy_intp faces_shape[1] = { engine.nn_faces };
+    npy_intp faceVerts_shape[1] = { engine.nn_face_verts };
+    PyObject* vertices = PyArray_SimpleNew(2, vertices_shape, NPY_FLOAT32);
+    PyObject* edges = PyArray_SimpleNew(2, edges_shape, NPY_INT32);
+    PyObject* vertsPerFace = PyArray_SimpleNew(1, faces_shape, NPY_INT32);
+    PyObject* faceVerts = PyArray_SimpleNew(1, faceVerts_shape, NPY_INT32);
+    PyObject* dict = NULL;
+    bool exported = vertices && edges && vertsPerFace && faceVerts && without_gil([&] {
+        engine.export_mesh((float*)PyArray_DATA((PyArrayObject*)vertices), (int*)PyArray_DATA((PyArrayObject*)edges), NULL);
+        engine.export_faces((int*)PyArray_DATA((PyArrayObject*)vertsPerFace), (int*)PyArray_DATA((PyArrayObject*)faceVerts));
+    });
+    if (exported) {
+        dict = Py_BuildValue("{s:O,s:O,s:O,s:O}", "vertices", vertices, "edges", edges, "vertsPerFace", vertsPerFace, "faceVerts", faceVerts);
+    }
+    Py_XDECREF(vertices);
+    Py_XDECREF(edges);
+    Py_XDECREF(vertsPerFace);
+    Py_XDECREF(faceVerts);
+    return dict;
+}
+
+static bool refine(subdivider& engine, PyObject* py_vertices, PyObject* py_faceVerts, PyObject* py_vertsPerFace) {
+    mesh_arrays mesh;
+    if (!mesh.acquire(py_vertices, py_faceVerts, py_vertsPerFace, engine.scheme)) {
+        return false;
+    }
+    float (*vertices)[3] = (float (*)[3])PyArray_DATA(mesh.vertices);
+    int* faceVerts = (int*)PyArray_DATA(mesh.faceVerts);
+    int* vertsPerFace = (int*)PyArray_DATA(mesh.vertsPerFace);
+    int n_verts = mesh.n_verts();
+    int n_faces = mesh.n_faces();
+    // The arrays stay referenced (and so alive) until mesh goes out of scope
+    return without_gil([&] {
+        engine.refine_topology(n_verts, n_faces, vertices, faceVerts, vertsPerFace);
+    });
+}
+
+//---------------- Subdivider type ----------------
+// Same rules as pysubdivision.Subdivider: one thread at a time per instance, separate instances in parallel.
+typedef struct {
+    PyObject_HEAD
+    subdivider* engine;
+} SubdividerObject;
+
+// The engine comes with the object (not with __init__), so every method can count on it, even on Subdivider.__new__(Subdivider)
+static PyObject* Subdivider_new(PyTypeObject* type, PyObject*, PyObject*) {
+    SubdividerObject* self = (SubdividerObject*)type->tp_alloc(type, 0);
+    if (self == NULL) {
+        return NULL;
+    }
+    self->engine = new (std::nothrow) subdivider();
+    if (self->engine == NULL) {
+        Py_DECREF(self);
+        return PyErr_NoMemory();
+    }
+    return (PyObject*)self;
+}
+
+static int Subdivider_init(SubdividerObject* self, PyObject* args, PyObject* kwds) {
+    static char const* kwlist[] = { "subdivision_level", "verbose", "threads", NULL };
+    int level = 0, verbose = 0, threads = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|ipi", (char**)kwlist, &level, &verbose, &threads)) {
+        return -1;
+    }
+    self->engine->settings(level, verbose, threads);
+    return 0;
+}
+
+static void Subdivider_dealloc(SubdividerObject* self) {
+    delete self->engine;
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static PyObject* Subdivider_settings(SubdividerObject* self, PyObject* args, PyObject* kwds) {
+    static char const* kwlist[] = { "subdivision_level", "verbose", "threads", NULL };
+    int level = 0, verbose = 0, threads = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "i|pi", (char**)kwlist, &level, &verbose, &threads)) {
+        return NULL;
+    }
+    self->engine->settings(level, verbose, threads);
+    Py_RETURN_NONE;
+}
+
+static PyObject* Subdivider_refine(SubdividerObject* self, PyObject* args) {
+    PyObject *vertices, *faceVerts, *vertsPerFace;
+    if (!PyArg_ParseTuple(args, "OOO", &vertices, &faceVerts, &vertsPerFace)) {
+        return NULL;
+    }
+    if (!refine(*self->engine, vertices, faceVerts, vertsPerFace)) {
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject* Subdivider_results(SubdividerObject* self, PyObject*) {
+    return results(*self->engine);
+}
+
+static PyObject* Subdivider_set_cache_size(SubdividerObject* self, PyObject* args) {
+    int cache_size;
+    if (!PyArg_ParseTuple(args, "i", &cache_size)) {
+        return NULL;
+    }
+    self->engine->set_cache_size(cache_size);
+    Py_RETURN_NONE;
+}
+
+static PyObject* Subdivider_use_stencils(SubdividerObject* self, PyObject* args) {
+    int enabled;
+    if (!PyArg_ParseTuple(args, "p", &enabled)) {
+        return NULL;
+    }
+    self->engine->set_stencils(enabled);
+    Py_RETURN_NONE;
+}
+
+static PyObject* Subdivider_set_scheme(SubdividerObject* self, PyObject* args) {
+    int scheme;
+    if (!PyArg_ParseTuple(args, "i", &scheme)) {
+        return NULL;
+    }
+    self->engine->set_scheme(scheme);
+    Py_RETURN_NONE;
+}
+
+static PyMethodDef Subdivider_methods[] = {
+    { "settings", (PyCFunction)(void(*)(void))Subdivider_settings, METH_VARARGS | METH_KEYWORDS, "settings(subdivision_level, verbose=False, threads=0)" },
+    { "refine", (PyCFunction)Subdivider_refine, METH_VARARGS, "refine(vertices, faceVerts, vertsPerFace), any array-likes (n x 3 float32 / int32 avoid a copy)" },
+    { "results", (PyCFunction)Subdivider_results, METH_NOARGS, "results() -> {'vertices', 'edges', 'vertsPerFace', 'faceVerts'} numpy arrays of the last refinement" },
+    { "set_cache_size", (PyCFunction)Subdivider_set_cache_size, METH_VARARGS, "set_cache_size(n), topologies kept around (0 = off)" },
+    { "use_stencils", (PyCFunction)Subdivider_use_stencils, METH_VARARGS, "use_stencils(enabled)" },
+    { "set_scheme", (PyCFunction)Subdivider_set_scheme, METH_VARARGS, "set_scheme(scheme), 0 = Bilinear, 1 = CatMark, 2 = Loop" },
+    { NULL, NULL, 0, NULL }
+};
+
+static PyTypeObject SubdividerType = { PyVarObject_HEAD_INIT(NULL, 0) };
+
+//---------------- Module functions ----------------
+// One engine per thread, like pysubdivision.thread_subdivider (so its topology cache carries over between calls)
+static subdivider& thread_engine() {
+    static thread_local std::unique_ptr<subdivider> engine;
+    if (!engine) {
+        engine.reset(new subdivider());
+    }
+    return *engine;
+}
+
+static PyObject* module_subdivide(PyObject*, PyObject* args, PyObject* kwds) {
+    static char const* kwlist[] = { "subdivision_level", "vertices", "faceVerts", "vertsPerFace", "verbose", NULL };
+    int level = 0, verbose = 0;
+    PyObject *vertices, *faceVerts, *vertsPerFace;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "iOOO|p", (char**)kwlist, &level, &vertices, &faceVerts, &vertsPerFace, &verbose)) {
+        return NULL;
+    }
+    subdivider& engine = thread_engine();
+    engine.settings(level, verbose);
+    if (!refine(engine, vertices, faceVerts, vertsPerFace)) {
+        return NULL;
+    }
+    return results(engine);
+}
+
+static PyMethodDef module_methods[] = {
+    { "subdivide", (PyCFunction)(void(*)(void))module_subdivide, METH_VARARGS | METH_KEYWORDS,
+      "subdivide(subdivision_level, vertices, faceVerts, vertsPerFace, verbose=False) -> dict of numpy arrays (see Subdivider.results)" },
+    { NULL, NULL, 0, NULL }
+};
+
+static struct PyModuleDef module_def = {
+    PyModuleDef_HEAD_INIT, "_pysubdivision", "OpenSubdiv subdivision, native interface (see pyOpenSubdiv.pysubdivision)", -1, module_methods
+};
+
+PyMODINIT_FUNC PyInit__pysubdivision(void) {
+    import_array();
+
+    SubdividerType.tp_name = "_pysubdivision.Subdivider";
+    SubdividerType.tp_basicsize = sizeof(SubdividerObject);
+    SubdividerType.tp_flags = Py_TPFLAGS_DEFAULT;
+    SubdividerType.tp_doc = "Subdivider(subdivision_level=0, verbose=False, threads=0)";
+    SubdividerType.tp_new = Subdivider_new;
+    SubdividerType.tp_init = (initproc)Subdivider_init;
+    SubdividerType.tp_dealloc = (destructor)Subdivider_dealloc;
+    SubdividerType.tp_methods = Subdivider_methods;
+    if (PyType_Ready(&SubdividerType) < 0) {
+        return NULL;
+    }
+
+    PyObject* module = PyModule_Create(&module_def);
+    if (module == NULL) {
+        return NULL;
+    }
+    Py_INCREF(&SubdividerType);
+    if (PyModule_AddObject(module, "Subdivider", (PyObject*)&SubdividerType) < 0) {
+        Py_DECREF(&SubdividerType);
+        Py_DECREF(module);
+        return NULL;
+    }
+    return module;
+}
@@ -0,0 +1,475 @@
+// Out-of-process subdivision worker, built on the same engine as ctypes_OpenSubdiv.so.
+// A pool of worker processes takes refine jobs over a Unix domain socket, so a crash on bad input or a huge refinement
+// takes down a worker (which gets restarted) instead of the host, and several client processes share one pool.
+// Meshes travel through POSIX shared memory: the request names a segment holding the incoming arrays, which the engine
+// reads in place, and the reply names a segment the results were exported into, which the client maps. Nothing is
+// serialized; the only copies are the ones the in-process API makes too (into and out of the engine).
+// Client side: pyOpenSubdiv/worker.py (WorkerSubdivider). POSIX only.
+// Example usage: ./subdivision_worker -s /tmp/pyOpenSubdiv.sock -n 4 -d /tmp/osd_cache
+//   -s <path>   socket path (default $XDG_RUNTIME_DIR/pyOpenSubdiv.sock, or /tmp/pyOpenSubdiv-<uid>.sock)
+//   -n <N>      worker processes (default one per core), each refining with up to cores / N threads
+//   -c <N>      topology cache size of every worker (default 8)
+//   -d <dir>    disk cache shared by the workers (see subdivider::set_disk_cache), off by default. Jobs are evaluated 
+//               through stencils when it's on, since those are what the cache files hold
+// Build with `make worker`.
+#if defined(_WIN32)
+#error "subdivision_worker needs POSIX sockets and shared memory"
+#endif
+
+#define SUBDIVIDER_NO_MAIN
+#include "ctypes_subdivider.cpp"
+
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <csignal>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+//---------------- Protocol ----------------
+// One fixed size request per job, answered by one fixed size reply, native byte order (both ends are on one machine).
+// worker.py packs the same layouts with struct, keep the two in sync (and bump worker_protocol_version on any change).
+//
+// Input segment (request.segment): vertices (3 floats each), faceVerts, vertsPerFace, back to back.
+// Output segment (reply.segment): vertices (3 floats each), edges (2 ints each), vertsPerFace, faceVerts, back to back.
+// Both names are unlinked as soon as nobody needs to open them anymore, so a client that dies mid-job leaves nothing
+// behind: the worker unlinks the input segment once it has mapped it, and the output segment of a reply when the
+// client sends its next request or hangs up (the client maps it before either, and unlinks it too).
+// The one window left is a client dying after creating its input segment but before the request is in.
+static const uint32_t worker_magic = 0x4f534457;
+static const uint32_t worker_protocol_version = 1;
+
+enum worker_op {
+    worker_refine = 1,
+    // Answers with an empty reply, to see whether a pool is up
+    worker_ping = 2
+};
+
+enum worker_status {
+    worker_ok = 0,
+    worker_bad_request = -1,
+    worker_bad_mesh = -2,
+    worker_no_memory = -3,
+    worker_failed = -4
+};
+
+struct worker_request {
+    uint32_t magic;
+    uint32_t version;
+    int32_t op;
+    // Settings of the subdivider (see subdivider::settings, set_scheme, set_reorder, set_stencils).
+    // threads is capped at the worker's share of the cores (0: all of that share).
+    int32_t maxlevel;
+    int32_t scheme;
+    int32_t threads;
+    int32_t reorder;
+    int32_t use_stencils;
+    int32_t n_verts;
+    int32_t n_faces;
+    int32_t n_faceVerts;
+    int32_t reserved;
+    // shm_open name, null terminated
+    char segment[64];
+};
+
+struct worker_reply {
+    uint32_t magic;
+    int32_t status;
+    int32_t nn_verts;
+    int32_t nn_edges;
+    int32_t nn_faces;
+    int32_t nn_face_verts;
+    int32_t cache_hit;
+    // Of the worker that did the job
+    int32_t pid;
+    char segment[64];
+    // What went wrong, for status != worker_ok
+    char message[128];
+};
+
+//---------------- Shared memory ----------------
+// A shared memory segment mapped for the duration of a job
+struct shared_segment {
+    shared_segment() : data(NULL), size(0) { }
+    ~shared_segment() {
+        if (data != NULL) {
+            munmap(data, size);
+        }
+    }
+
+    // Maps an existing segment (read only), false if there's none or it's smaller than `needed`
+    bool open(char const* name, size_t needed) {
+        int fd = shm_open(name, O_RDONLY, 0);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat st;
+        bool ok = fstat(fd, &st) == 0 && (size_t)st.st_size >= needed;
+        if (ok && needed > 0) {
+            size = needed;
+            data = (char*)mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+            ok = data != MAP_FAILED;
+            if (!ok) {
+                data = NULL;
+            }
+        }
+        close(fd);
+        return ok;
+    }
+
+    // Creates and maps a new segment of `bytes` (at least 8, so empty results still get a segment that can be mapped)
+    bool create(char const* name, size_t bytes) {
+        int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) {
+            return false;
+        }
+        size = std::max<size_t>(bytes, 8);
+        bool ok = ftruncate(fd, size) == 0;
+        if (ok) {
+            data = (char*)mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            ok = data != MAP_FAILED;
+            if (!ok) {
+                data = NULL;
+            }
+        }
+        close(fd);
+        if (!ok) {
+            shm_unlink(name);
+        }
+        return ok;
+    }
+
+    char* data;
+    size_t size;
+
+private:
+    shared_segment(shared_segment const&);
+    shared_segment& operator=(shared_segment const&);
+};
+
+//---------------- Jobs ----------------
+// What OpenSubdiv would otherwise assert or crash on
+static bool valid_mesh(worker_request const& request, int const* faceVerts, int const* vertsPerFace, std::string& error) {
+    int64_t n_faceVerts = 0;
+    for (int f = 0; f < request.n_faces; f++) {
+        if (vertsPerFace[f] < 3 || (request.scheme == Sdc::SCHEME_LOOP && vertsPerFace[f] != 3)) {
+            error = "face " + std::to_string(f) + " has " + std::to_string(vertsPerFace[f]) + " vertices";
+            return false;
+        }
+        n_faceVerts += vertsPerFace[f];
+    }
+    if (n_faceVerts != request.n_faceVerts) {
+        error = "faceVerts: expected sum(vertsPerFace) indices";
+        return false;
+    }
+    for (int i = 0; i < request.n_faceVerts; i++) {
+        if (faceVerts[i] < 0 || faceVerts[i] >= request.n_verts) {
+            error = "face vertex " + std::to_string(faceVerts[i]) + " out of range";
+            return false;
+        }
+    }
+    return true;
+}
+
+static void fail(worker_reply& reply, int status, std::string const& message) {
+    reply.status = status;
+    strncpy(reply.message, message.c_str(), sizeof(reply.message) - 1);
+}
+
+// threads: the most threads one job may use (see serve_connections), disk_cache: whether the pool has one (see main) 
+static void serve_request(subdivider& engine, worker_request const& request, int threads, bool disk_cache, worker_reply& reply) {
+    memset(&reply, 0, sizeof(reply));
+    reply.magic = worker_magic;
+    reply.pid = getpid();
+    if (request.magic != worker_magic || request.version != worker_protocol_version) {
+        fail(reply, worker_bad_request, "protocol version mismatch");
+        return;
+    }
+    if (request.op == worker_ping) {
+        return;
+    }
+    if (request.op != worker_refine || request.n_verts < 0 || request.n_faces < 0 || request.n_faceVerts < 0
+        || memchr(request.segment, 0, sizeof(request.segment)) == NULL) {
+        fail(reply, worker_bad_request, "malformed request");
+        return;
+    }
+
+    // -------- Incoming mesh, read in place --------
+    size_t vertex_bytes = 12 * (size_t)request.n_verts;
+    size_t input_bytes = vertex_bytes + 4 * ((size_t)request.n_faceVerts + request.n_faces);
+    shared_segment input;
+    if (!input.open(request.segment, input_bytes)) {
+        fail(reply, worker_bad_request, std::string("can't map ") + request.segment);
+        return;
+    }
+    // Stays mapped, and the name goes even if the client dies before it gets to unlink it
+    shm_unlink(request.segment);
+    float (*vertices)[3] = request.n_verts > 0 ? (float (*)[3])input.data : NULL;
+    int* faceVerts = (int*)(input.data + vertex_bytes);
+    int* vertsPerFace = faceVerts + request.n_faceVerts;
+    std::string error;
+    if (!valid_mesh(request, faceVerts, vertsPerFace, error)) {
+        fail(reply, worker_bad_mesh, error);
+        return;
+    }
+
+    // -------- Refine --------
+    // (the engine only reads the incoming arrays, the mapping is read only)
+    engine.settings(std::max(request.maxlevel, 0), false, request.threads > 0 ? std::min(request.threads, threads) : threads);
+    engine.set_scheme(request.scheme);
+    engine.set_reorder(request.reorder);
+    engine.set_stencils(request.use_stencils || disk_cache);
+    try {
+        engine.refine_topology(request.n_verts, request.n_faces, vertices, faceVerts, vertsPerFace);
+    } catch (std::bad_alloc const&) {
+        fail(reply, worker_no_memory, "out of memory");
+        return;
+    } catch (std::exception const& e) {
+        fail(reply, worker_failed, e.what());
+        return;
+    }
+
+    // -------- Results, exported straight into a new segment --------
+    static unsigned counter = 0;
+    snprintf(reply.segment, sizeof(reply.segment), "/pyOpenSubdiv-%d-%u", (int)getpid(), ++counter);
+    size_t output_ints = 3 * (size_t)engine.nn_verts + 2 * (size_t)engine.nn_edges + engine.nn_faces + engine.nn_face_verts;
+    shared_segment output;
+    if (!output.create(reply.segment, 4 * output_ints)) {
+        reply.segment[0] = 0;
+        fail(reply, worker_no_memory, "can't create the result segment");
+        return;
+    }
+    float* new_vertices = (float*)output.data;
+    int* edges = (int*)(new_vertices + 3 * (size_t)engine.nn_verts);
+    int* new_vertsPerFace = edges + 2 * (size_t)engine.nn_edges;
+    int* new_faceVerts = new_vertsPerFace + engine.nn_faces;
+    engine.export_mesh(new_vertices, edges, NULL);
+    engine.export_faces(new_vertsPerFace, new_faceVerts);
+
+    reply.nn_verts = engine.nn_verts;
+    reply.nn_edges = engine.nn_edges;
+    reply.nn_faces = engine.nn_faces;
+    reply.nn_face_verts = engine.nn_face_verts;
+    reply.cache_hit = engine.cache_hit;
+}
+
+//---------------- Workers ----------------
+static bool read_full(int fd, void* data, size_t size) {
+    char* p = (char*)data;
+    while (size > 0) {
+        ssize_t n = read(fd, p, size);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        size -= n;
+    }
+    return true;
+}
+
+static bool write_full(int fd, void const* data, size_t size) {
+    char const* p = (char const*)data;
+    while (size > 0) {
+        ssize_t n = write(fd, p, size);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        size -= n;
+    }
+    return true;
+}
+
+// One worker process: takes connections off the shared listening socket, one at a time, and answers every request
+// on them until the client hangs up. Its subdivider (and topology cache) lives as long as the process.
+// Every worker refines with at most `threads` threads, its share of the cores, so a busy pool doesn't run
+// n_workers thread pools of hardware_threads() each.
+static void serve_connections(int listener, int cache_size, char const* disk_cache, int threads) {
+    subdivider engine;
+    engine.set_cache_size(cache_size);
+    engine.set_disk_cache(disk_cache);
+    for (;;) {
+        int client = accept(listener, NULL, NULL);
+        if (client < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            _exit(1);
+        }
+        worker_request request;
+        worker_reply reply;
+        reply.segment[0] = 0;
+        while (read_full(client, &request, sizeof(request))) {
+            // The client has mapped the last results by now (or never will), see Protocol 
+            if (reply.segment[0] != 0) {
+                shm_unlink(reply.segment);
+            }
+            serve_request(engine, request, threads, disk_cache != NULL, reply);
+            if (!write_full(client, &reply, sizeof(reply))) {
+                break;
+            }
+        }
+        if (reply.segment[0] != 0) {
+            shm_unlink(reply.segment);
+        }
+        close(client);
+    }
+}
+
+static volatile sig_atomic_t stopping = 0;
+
+static void stop_pool(int) {
+    stopping = 1;
+}
+
+static std::string default_socket_path() {
+    char const* runtime_dir = getenv("XDG_RUNTIME_DIR");
+    if (runtime_dir != NULL && runtime_dir[0] != 0) {
+        return std::string(runtime_dir) + "/pyOpenSubdiv.sock";
+    }
+    return "/tmp/pyOpenSubdiv-" + std::to_string((long)getuid()) + ".sock";
+}
+
+int main(int argc, char** argv) {
+    std::string socket_path = default_socket_path();
+    int n_workers = 0;
+    int cache_size = 8;
+    char const* disk_cache = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "-s" && has_value) {
+            socket_path = argv[++i];
+        } else if (arg == "-n" && has_value) {
+            n_workers = std::atoi(argv[++i]);
+        } else if (arg == "-c" && has_value) {
+            cache_size = std::atoi(argv[++i]);
+        } else if (arg == "-d" && has_value) {
+            disk_cache = argv[++i];
+        } else {
+            std::cerr << "unknown argument " << arg << std::endl;
+            return 1;
+        }
+    }
+    if (n_workers <= 0) {
+        n_workers = hardware_threads();
+    }
+    int worker_threads = std::max(hardware_threads() / n_workers, 1);
+
+    // -------- Listening socket --------
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(address.sun_path)) {
+        std::cerr << socket_path << ": socket path too long" << std::endl;
+        return 1;
+    }
+    strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        perror("socket");
+        return 1;
+    }
+    if (connect(listener, (struct sockaddr*)&address, sizeof(address)) == 0) {
+        std::cerr << socket_path << ": a pool is already serving there" << std::endl;
+        return 0;
+    }
+    close(listener);
+    // Left over from a pool that didn't shut down cleanly
+    unlink(socket_path.c_str());
+    listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    mode_t mask = umask(0177);
+    bool bound = bind(listener, (struct sockaddr*)&address, sizeof(address)) == 0;
+    umask(mask);
+    if (!bound || listen(listener, 128) != 0) {
+        perror(socket_path.c_str());
+        return 1;
+    }
+
+    // -------- Pool --------
+    // A client that hangs up mid-reply must not kill its worker
+    signal(SIGPIPE, SIG_IGN);
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = stop_pool;
+    sigaction(SIGTERM, &action, NULL);
+    sigaction(SIGINT, &action, NULL);
+
+    std::vector<pid_t> workers;
+    for (int w = 0; w < n_workers; w++) {
+        workers.push_back(-1);
+    }
+    for (;;) {
+        // (Re)start every worker slot that's empty
+        bool fork_failed = false;
+        for (size_t w = 0; w < workers.size() && !stopping && !fork_failed; w++) {
+            if (workers[w] > 0) {
+                continue;
+            }
+            pid_t pid = fork();
+            if (pid < 0) {
+                // Out of processes or memory: the slot stays empty and is retried after a pause
+                perror("fork");
+                fork_failed = true;
+                continue;
+            }
+            if (pid == 0) {
+                signal(SIGTERM, SIG_DFL);
+                signal(SIGINT, SIG_DFL);
+                serve_connections(listener, cache_size, disk_cache, worker_threads);
+                _exit(0);
+            }
+            workers[w] = pid;
+        }
+        if (stopping) {
+            break;
+        }
+        // After a failed fork, reap whatever already exited without blocking (there may be no worker left to wait for)
+        int status = 0;
+        pid_t pid = waitpid(-1, &status, fork_failed ? WNOHANG : 0);
+        if (pid <= 0) {
+            if (pid < 0 && errno != EINTR && !(fork_failed && errno == ECHILD)) {
+                break;
+            }
+            if (fork_failed) {
+                sleep(1);
+            }
+            continue;
+        }
+        for (size_t w = 0; w < workers.size(); w++) {
+            if (workers[w] == pid) {
+                workers[w] = -1;
+            }
+        }
+        if (WIFSIGNALED(status)) {
+            std::cerr << "worker " << pid << " died (signal " << WTERMSIG(status) << "), restarting" << std::endl;
+        } else {
+            std::cerr << "worker " << pid << " exited (" << WEXITSTATUS(status) << "), restarting" << std::endl;
+        }
+    }
+
+    for (pid_t pid : workers) {
+        if (pid > 0) {
+            kill(pid, SIGTERM);
+        }
+    }
+    while (waitpid(-1, NULL, 0) > 0 || errno == EINTR) {
+    }
+    close(listener);
+    unlink(socket_path.c_str());
+    return 0;
+}